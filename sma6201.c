@@ -32,31 +32,52 @@
 #include <linux/thermal.h>
 #include <linux/power_supply.h>
 #include <linux/kfifo.h>
+#include <linux/pm_runtime.h>
 #include <linux/list.h>
 #include <linux/uaccess.h>
+#include <linux/sort.h>
+#include <linux/ktime.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/completion.h>
+#include <linux/log2.h>
 #include "sma6201.h"
+#include "sma6201_pll.h"
+
+#define CREATE_TRACE_POINTS
+#include "sma6201_trace.h"
 
 #define CHECK_COMP_PERIOD_TIME 10 /* sec per HZ */
+#define CHECK_COMP_PERIOD_MIN 1 /* sec per HZ */
+#define CHECK_COMP_PERIOD_MAX 60 /* sec per HZ */
+#define CHECK_COMP_FAR_DEG 50 /* 5.0C from a breakpoint polls at the max */
 #define CHECK_FAULT_PERIOD_TIME 5 /* sec per HZ */
 #define DELAYED_SHUTDOWN_TIME 3 /* sec per HZ */
+#define MUTE_SLOPE_TIME 15 /* msec */
+#define WARM_STANDBY_TIME 0 /* msec, off unless set through sysfs */
+#define STARTUP_DONE_TIMEOUT 500 /* msec */
+#define TUNING_DONE_TIMEOUT 1000 /* msec */
+#define PLL_LOCK_POLL_US 500
+#define PLL_LOCK_TIMEOUT_US 5000
+
+/* The chip has no boost ready bit. The fixed delay after POWER_ON stays
+ * as the floor(boost OCP interrupt at turn on), then the boost fault
+ * bits of STATUS2 are checked and waited out if still set.
+ */
+#define STARTUP_READY_FLOOR_MS 20
+#define STARTUP_READY_MIN_US 1000
+#define STARTUP_READY_MASK (OCP_BST_STATUS|UVLO_BST_STATUS)
+#define STARTUP_READY_POLL_US 500
+#define STARTUP_READY_TIMEOUT_US 20000
+#define STARTUP_READY_HIST_BUCKETS 42 /* 1ms per bucket */
 
 #define FIFO_BUFFER_SIZE 10
 #define VBAT_TABLE_NUM 4
+#define VBAT_FILTER_WEIGHT 4 /* a new sample counts 1/4 */
+#define VBAT_HYST_MV 50
 
 #define PLL_DEFAULT_SET 1
-
-#define PLL_MATCH(_input_clk_name, _output_clk_name, _input_clk,\
-		_post_n, _n, _f1, _f2, _f3_p_cp)\
-{\
-	.input_clk_name		= _input_clk_name,\
-	.output_clk_name	= _output_clk_name,\
-	.input_clk		= _input_clk,\
-	.post_n			= _post_n,\
-	.n			= _n,\
-	.f1			= _f1,\
-	.f2			= _f2,\
-	.f3_p_cp		= _f3_p_cp,\
-}
+#define PLL_CACHE_SIZE 4
 
 #define TEMP_GAIN_MATCH(_thermal_deg_name, _thermal_limit, _comp_gain,\
 		_ocp_count, _hit_count, _activate)\
@@ -70,10 +91,11 @@
 }
 
 #define VBAT_GAIN_MATCH(_vbat_level_name, _vbat_level,\
-		_comp_gain)\
+		_vbat_limit_mV, _comp_gain)\
 {\
 	.lvl_name		= _vbat_level_name,\
 	.vbat_level		= _vbat_level,\
+	.vbat_limit_mV		= _vbat_limit_mV,\
 	.comp_gain		= _comp_gain,\
 }
 
@@ -81,25 +103,22 @@ enum sma6201_type {
 	SMA6201,
 };
 
-/* PLL clock setting Table */
-struct sma6201_pll_match {
-	char *input_clk_name;
-	char *output_clk_name;
-	unsigned int input_clk;
-	unsigned int post_n;
-	unsigned int n;
-	unsigned int f1;
-	unsigned int f2;
-	unsigned int f3_p_cp;
-};
-
 struct outside_status {
 	unsigned int id;
 	int thermal_deg;
-	int batt_voltage_mV;
 	int interval;
 };
 
+/* Status register snapshot : 0xFA ~ 0xFF */
+struct sma6201_status {
+	unsigned int over_temp;		/* 0xFA STATUS1 */
+	unsigned int ocp_val;		/* 0xFB STATUS2 */
+	unsigned int sar_adc;		/* 0xFC STATUS3 */
+	unsigned int status4;		/* 0xFD STATUS4 */
+	unsigned int bop_state;		/* 0xFE STATUS5 */
+	unsigned int version;		/* 0xFF Device Info */
+};
+
 struct sma6201_temperature_match {
 	char *thermal_deg_name;
 	int thermal_limit;
@@ -112,26 +131,178 @@ struct sma6201_temperature_match {
 struct sma6201_vbat_gain_match {
 	char *lvl_name;
 	int vbat_level;
+	int vbat_limit_mV;	/* lowest voltage of the level */
 	int comp_gain;
 };
 
+/* Class-H scene switch statistics */
+struct sma6201_scene_stats {
+	unsigned int switches;
+	unsigned int last_writes;
+	unsigned long long total_writes;
+	s64 last_latency_us;
+	s64 max_latency_us;
+};
+
+/* Boost ready time after POWER_ON in sma6201_startup */
+struct sma6201_ready_stats {
+	unsigned int count;
+	unsigned int timeouts;
+	unsigned int errors;
+	s64 min_us;
+	s64 max_us;
+	s64 total_us;
+	unsigned int hist[STARTUP_READY_HIST_BUCKETS];
+};
+
+/* Runtime PM statistics */
+struct sma6201_pm_stats {
+	unsigned int suspends;
+	unsigned int resumes;
+	unsigned int warm_starts;
+	unsigned int standbys;
+	s64 last_resume_us;
+	s64 max_resume_us;
+	s64 total_resume_us;
+};
+
+/* Stream start latency : how long the DAC power up blocks DAPM,
+ * and the first sound(unmute of a running stream) measured from the
+ * DAC power up and from the DAI trigger
+ */
+struct sma6201_start_stats {
+	spinlock_t lock;
+	ktime_t pmu_time;
+	ktime_t unmute_time;
+	ktime_t trigger_time;
+	unsigned int blocks;
+	s64 last_block_us;
+	s64 max_block_us;
+	s64 total_block_us;
+	unsigned int count;
+	s64 last_trigger_us;
+	s64 max_trigger_us;
+	s64 total_trigger_us;
+	s64 last_sound_us;
+	s64 max_sound_us;
+	s64 total_sound_us;
+};
+
+/* Contiguous register run of the init image */
+struct sma6201_init_block {
+	int idx;
+	int len;
+};
+
+/* Power lifecycle phases with a rolling duration window each */
+enum sma6201_phase {
+	SMA6201_PHASE_PROBE,
+	SMA6201_PHASE_RESET,
+	SMA6201_PHASE_TUNING,
+	SMA6201_PHASE_HW_PARAMS,
+	SMA6201_PHASE_SETUP_PLL,
+	SMA6201_PHASE_STARTUP,
+	SMA6201_PHASE_SHUTDOWN,
+	SMA6201_PHASE_STANDBY,
+	SMA6201_PHASE_POWER_DOWN,
+	SMA6201_PHASE_RESUME,
+	SMA6201_PHASE_ADC_FEEDBACK,
+	SMA6201_PHASE_MAX,
+};
+
+#define SMA6201_PHASE_WINDOW	128
+
+struct sma6201_phase_stats {
+	unsigned long long count;
+	unsigned int head;
+	u32 samples_us[SMA6201_PHASE_WINDOW];
+};
+
+/* Call sites of the driver register accesses for the I2C accounting */
+enum sma6201_io_site {
+	SMA6201_IO_KCONTROL,
+	SMA6201_IO_PROBE,
+	SMA6201_IO_TUNING,
+	SMA6201_IO_HW_PARAMS,
+	SMA6201_IO_SETUP_PLL,
+	SMA6201_IO_DAI,
+	SMA6201_IO_DAPM,
+	SMA6201_IO_STARTUP,
+	SMA6201_IO_SHUTDOWN,
+	SMA6201_IO_STANDBY,
+	SMA6201_IO_RUNTIME_PM,
+	SMA6201_IO_ISR,
+	SMA6201_IO_FAULT_WORKER,
+	SMA6201_IO_VBAT_WORKER,
+	SMA6201_IO_TEMP_WORKER,
+	SMA6201_IO_SITE_MAX,
+};
+
+/* Register access types of the latency histograms */
+enum sma6201_io_op {
+	SMA6201_IO_READ,
+	SMA6201_IO_WRITE,
+	SMA6201_IO_UPDATE_BITS,
+	SMA6201_IO_BULK_READ,
+	SMA6201_IO_BULK_WRITE,
+	SMA6201_IO_OP_MAX,
+};
+
+/* log2 buckets : <1us, then [2^(n-1), 2^n)us, the last one open ended */
+#define SMA6201_IO_HIST_BUCKETS	16
+
+struct sma6201_io_site_stats {
+	unsigned long long calls;
+	unsigned long long xfers;
+	unsigned long long time_ns;
+	unsigned long long max_ns;
+};
+
+/* Register counters at the regmap address, EQ banks included */
+struct sma6201_io_stats {
+	spinlock_t lock;
+	struct sma6201_io_site_stats site[SMA6201_IO_SITE_MAX];
+	unsigned int reads[SMA6201_EQ_BANK_MAX + 1];
+	unsigned int writes[SMA6201_EQ_BANK_MAX + 1];
+	unsigned int hist[SMA6201_IO_OP_MAX][SMA6201_IO_HIST_BUCKETS];
+};
+
+/* Power state fields written on every amp transition */
+enum sma6201_shadow_field {
+	SMA6201_SHADOW_POWER,
+	SMA6201_SHADOW_MUTE,
+	SMA6201_SHADOW_SPK_MODE,
+	SMA6201_SHADOW_TONE_ON,
+	SMA6201_SHADOW_TONE_VOL,
+	SMA6201_SHADOW_DIS_IRQ,
+	SMA6201_SHADOW_PLL_LDO_BYP,
+	SMA6201_SHADOW_MAX,
+};
+
+struct sma6201_shadow {
+	struct mutex lock;
+	unsigned long valid;
+	unsigned int val[SMA6201_SHADOW_MAX];
+};
+
 struct sma6201_priv {
 	enum sma6201_type devtype;
 	struct attribute_group *attr_grp;
 	struct kobject *kobj;
 	struct regmap *regmap;
 	struct sma6201_pll_match *pll_matches;
-	struct wakeup_source shutdown_wakesrc;
 	int num_of_pll_matches;
+	struct sma6201_pll_match pll_cache[PLL_CACHE_SIZE];
+	int pll_cache_next;
 	struct sma6201_temperature_match *temp_match;
 	int num_of_temperature_matches;
 	unsigned int mclk_in;
 	unsigned int sys_clk_id;
 	unsigned int init_vol;
-	unsigned int last_rate;
-	unsigned int last_width;
-	unsigned int last_channel;
+	unsigned int pll_ref_clk;
 	bool amp_power_status;
+	bool dai_mute;
+	struct mutex mute_lock;
 	bool ext_clk_status;
 	bool force_amp_power_down;
 	bool stereo_two_chip;
@@ -142,29 +313,72 @@ struct sma6201_priv {
 	const uint32_t *bo_reg_array;
 	uint32_t eq_reg_array_len;
 	uint32_t bo_reg_array_len;
+	struct reg_sequence *init_seq;
+	u8 *init_val;
+	int init_seq_len;
+	struct sma6201_init_block *init_blocks;
+	int num_init_blocks;
+	u8 *cache_snapshot;
+	bool cache_deferred;
+	struct sma6201_scene_stats scene_stats;
+	struct sma6201_ready_stats ready_stats;
+	struct sma6201_pm_stats pm_stats;
+	bool pm_restart;
+	struct sma6201_start_stats start_stats;
+	bool async_startup;
+	struct work_struct startup_work;
+	struct completion startup_done;
+	struct work_struct tuning_work;
+	struct completion tuning_done;
+	bool tuning_applied;
+	spinlock_t phase_lock;
+	struct sma6201_phase_stats phases[SMA6201_PHASE_MAX];
+	struct sma6201_io_stats io_stats;
+	struct sma6201_shadow shadow;
+	struct dentry *debugfs_root;
 	unsigned int format;
 	struct device *dev;
 	struct delayed_work check_thermal_vbat_work;
 	struct delayed_work check_thermal_fault_work;
-	struct delayed_work delayed_shutdown_work;
+	struct delayed_work standby_work;
+	ktime_t mute_time;
 	int irq;
 	int gpio_int;
 	int gpio_reset;
 	unsigned int rev_num;
 	atomic_t irq_enabled;
 	unsigned int ocp_count;
-	struct thermal_zone_device *tz_sense;
+	struct thermal_cooling_device *gain_cdev;
+	struct work_struct temp_work;
+	unsigned long gain_state;
+	bool temp_event;
+	struct thermal_zone_device *tz;
+	unsigned long temp_trips;
+	bool gain_cdev_mapped;
 	struct power_supply *batt_psy;
+#ifdef CONFIG_SMA6201_BATTERY_READING
+	struct notifier_block psy_nb;
+	struct work_struct vbat_work;
+#endif
+	int vbat_mV;		/* filtered, 0 before the first sample */
+	int vbat_status;	/* sma6201_vbat_gain_matches row, -1 unknown */
 	struct kfifo data_fifo;
 	int fifo_count;
 	struct mutex lock;
 	uint32_t threshold_level;
 	long check_thermal_vbat_period;
+	long check_thermal_vbat_period_min;
+	long check_thermal_vbat_period_max;
+	long check_thermal_vbat_period_cur;
+	unsigned long check_thermal_vbat_wakeups;
+	int thermal_prev_deg;
+	unsigned long thermal_prev_jiffies; /* 0 : no previous reading */
 	long check_thermal_vbat_enable;
 	long check_thermal_fault_period;
 	long check_thermal_fault_enable;
 	long delayed_shutdown_enable;
 	long delayed_time_shutdown;
+	long warm_standby_time;
 	long temp_table_number;
 	long temp_limit;
 	long temp_comp_gain;
@@ -176,23 +390,12 @@ struct sma6201_priv {
 	int lowbattery_status;
 };
 
-static struct sma6201_pll_match sma6201_pll_matches[] = {
-/* in_clk_name, out_clk_name, input_clk, post_n, n, f1, f2, f3_p_cp */
-PLL_MATCH("1.411MHz",  "24.595MHz", 1411200,  0x07, 0xF4, 0x00, 0x00, 0x03),
-PLL_MATCH("1.536MHz",  "24.576MHz", 1536000,  0x07, 0xE0, 0x00, 0x00, 0x03),
-PLL_MATCH("3.072MHz",  "24.576MHz", 3072000,  0x07, 0x70, 0x00, 0x00, 0x03),
-PLL_MATCH("6.144MHz",  "24.576MHz", 6144000,  0x07, 0x70, 0x00, 0x00, 0x07),
-PLL_MATCH("12.288MHz", "24.576MHz", 12288000, 0x07, 0x70, 0x00, 0x00, 0x0B),
-PLL_MATCH("19.2MHz",   "24.343MHz", 19200000, 0x07, 0x47, 0x00, 0x00, 0x0A),
-PLL_MATCH("24.576MHz", "24.576MHz", 24576000, 0x07, 0x70, 0x00, 0x00, 0x0F),
-};
-
 static const struct sma6201_vbat_gain_match sma6201_vbat_gain_matches[] = {
-/* level name,level, comp gain*/
-VBAT_GAIN_MATCH("Normal LVL", 3, 0x00),
-VBAT_GAIN_MATCH("LVL 2", 2, 0x02),
-VBAT_GAIN_MATCH("LVL 1", 1, 0x04),
-VBAT_GAIN_MATCH("LVL 0", 0, 0x06),
+/* level name,level, voltage limit, comp gain*/
+VBAT_GAIN_MATCH("Normal LVL", 3, 3600, 0x00),
+VBAT_GAIN_MATCH("LVL 2", 2, 3500, 0x02),
+VBAT_GAIN_MATCH("LVL 1", 1, 3400, 0x04),
+VBAT_GAIN_MATCH("LVL 0", 0, 0, 0x06),
 };
 
 #ifndef CONFIG_MACH_PIEZO
@@ -233,7 +436,19 @@ TEMP_GAIN_MATCH("100.0", 1000, 0xd, 0, 0, 1), /* max */
 static int sma6201_startup(struct snd_soc_component *);
 static int sma6201_shutdown(struct snd_soc_component *);
 static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
-					bool ocp_status);
+		enum sma6201_io_site site, bool ocp_status);
+static int sma6201_temp_comp_apply(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, int i, int vbat_gain);
+static bool sma6201_temp_events(struct sma6201_priv *sma6201);
+static bool sma6201_gain_cdev_bound(struct sma6201_priv *sma6201);
+
+/* Flat frequency response of one EQ Band (15EA register from band start) */
+#define EQ_BAND_FLAT_DEF(base) \
+	{ (base) + 0, 0x00 }, { (base) + 1, 0x00 }, { (base) + 2, 0x00 }, \
+	{ (base) + 3, 0x00 }, { (base) + 4, 0x00 }, { (base) + 5, 0x00 }, \
+	{ (base) + 6, 0x20 }, { (base) + 7, 0x00 }, { (base) + 8, 0x00 }, \
+	{ (base) + 9, 0x00 }, { (base) + 10, 0x00 }, { (base) + 11, 0x00 }, \
+	{ (base) + 12, 0x00 }, { (base) + 13, 0x00 }, { (base) + 14, 0x00 }
 
 /* Initial register value - {register, value}
  * EQ Band : 1 to 10 / 0x40 to 0x8A (15EA register for each EQ Band)
@@ -431,11 +646,23 @@ static const struct reg_default sma6201_reg_def[] = {
 	{ 0xFD, 0x00 }, /* 0xFD Status4  */
 	{ 0xFE, 0x00 }, /* 0xFE Status5  */
 	{ 0xFF, 0xD0 }, /* 0xFF Device Info  */
+	/* EQ1 Bank : 0x40 ~ 0x8A through EQ_BANK_SEL */
+	EQ_BAND_FLAT_DEF(SMA6201_EQ1_REG(SMA6201_40_EQ_CTRL1)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ1_REG(SMA6201_4F_EQ_CTRL16)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ1_REG(SMA6201_5E_EQ_CTRL31)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ1_REG(SMA6201_6D_EQ_CTRL46)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ1_REG(SMA6201_7C_EQ_CTRL61)),
+	/* EQ2 Bank : 0x40 ~ 0x8A through EQ_BANK_SEL */
+	EQ_BAND_FLAT_DEF(SMA6201_EQ2_REG(SMA6201_40_EQ_CTRL1)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ2_REG(SMA6201_4F_EQ_CTRL16)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ2_REG(SMA6201_5E_EQ_CTRL31)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ2_REG(SMA6201_6D_EQ_CTRL46)),
+	EQ_BAND_FLAT_DEF(SMA6201_EQ2_REG(SMA6201_7C_EQ_CTRL61)),
 };
 
 static bool sma6201_readable_register(struct device *dev, unsigned int reg)
 {
-	if (reg > SMA6201_FF_VERSION)
+	if (reg > SMA6201_EQ_BANK_MAX)
 		return false;
 
 	switch (reg) {
@@ -446,6 +673,7 @@ static bool sma6201_readable_register(struct device *dev, unsigned int reg)
 	case SMA6201_9C_VOLUME_PGA_ISENSE ... SMA6201_A0_ADC_MUTE_VOL_CTRL:
 	case SMA6201_A2_TOP_MAN1 ... SMA6201_BF_BROWN_OUT_P15:
 	case SMA6201_FA_STATUS1 ... SMA6201_FF_VERSION:
+	case SMA6201_EQ1_BANK_BASE ... SMA6201_EQ_BANK_MAX:
 		return true;
 	default:
 		return false;
@@ -454,7 +682,7 @@ static bool sma6201_readable_register(struct device *dev, unsigned int reg)
 
 static bool sma6201_writeable_register(struct device *dev, unsigned int reg)
 {
-	if (reg > SMA6201_FF_VERSION)
+	if (reg > SMA6201_EQ_BANK_MAX)
 		return false;
 
 	switch (reg) {
@@ -465,6 +693,7 @@ static bool sma6201_writeable_register(struct device *dev, unsigned int reg)
 	case SMA6201_9C_VOLUME_PGA_ISENSE ... SMA6201_A0_ADC_MUTE_VOL_CTRL:
 	case SMA6201_A2_TOP_MAN1 ... SMA6201_BF_BROWN_OUT_P15:
 	case SMA6201_FA_STATUS1 ... SMA6201_FF_VERSION:
+	case SMA6201_EQ1_BANK_BASE ... SMA6201_EQ_BANK_MAX:
 		return true;
 	default:
 		return false;
@@ -474,6 +703,8 @@ static bool sma6201_writeable_register(struct device *dev, unsigned int reg)
 static bool sma6201_volatile_register(struct device *dev, unsigned int reg)
 {
 	switch (reg) {
+	/* EQ window is only accessed through the EQ1/EQ2 bank range */
+	case SMA6201_40_EQ_CTRL1 ... SMA6201_8A_EQ_CTRL75:
 	case SMA6201_FA_STATUS1 ... SMA6201_FF_VERSION:
 		return true;
 	default:
@@ -481,6 +712,506 @@ static bool sma6201_volatile_register(struct device *dev, unsigned int reg)
 	}
 }
 
+/* Map an EQ window address(0x40 ~ 0x8A) given by DT
+ * to the virtual register of the selected EQ bank
+ */
+static unsigned int sma6201_eq_bank_reg(unsigned int bank_base,
+		unsigned int reg)
+{
+	if (reg < SMA6201_EQ_WINDOW_START ||
+		reg >= SMA6201_EQ_WINDOW_START + SMA6201_EQ_WINDOW_LEN)
+		return reg;
+
+	return reg - SMA6201_EQ_WINDOW_START + bank_base;
+}
+
+/* I2C traffic accounting
+ * Every register access of the driver goes through the sma6201_io_*
+ * wrappers below with its call site. A call is charged to the site
+ * with its latency, the bus transfers it made and the registers
+ * those transfers read or wrote. Reads of cached registers and writes
+ * in cache only mode(amp powered down) make no bus transfer.
+ * Calls that made one also go to the latency histogram of their
+ * access type. Each call is traced by the sma6201_io event.
+ */
+static const char * const sma6201_io_site_names[SMA6201_IO_SITE_MAX] = {
+	[SMA6201_IO_KCONTROL] = "kcontrol",
+	[SMA6201_IO_PROBE] = "probe",
+	[SMA6201_IO_TUNING] = "tuning",
+	[SMA6201_IO_HW_PARAMS] = "hw_params",
+	[SMA6201_IO_SETUP_PLL] = "setup_pll",
+	[SMA6201_IO_DAI] = "dai",
+	[SMA6201_IO_DAPM] = "dapm",
+	[SMA6201_IO_STARTUP] = "startup",
+	[SMA6201_IO_SHUTDOWN] = "shutdown",
+	[SMA6201_IO_STANDBY] = "standby",
+	[SMA6201_IO_RUNTIME_PM] = "runtime_pm",
+	[SMA6201_IO_ISR] = "isr",
+	[SMA6201_IO_FAULT_WORKER] = "fault_worker",
+	[SMA6201_IO_VBAT_WORKER] = "vbat_worker",
+	[SMA6201_IO_TEMP_WORKER] = "temp_worker",
+};
+
+static const char * const sma6201_io_op_names[SMA6201_IO_OP_MAX] = {
+	[SMA6201_IO_READ] = "read",
+	[SMA6201_IO_WRITE] = "write",
+	[SMA6201_IO_UPDATE_BITS] = "update_bits",
+	[SMA6201_IO_BULK_READ] = "bulk_read",
+	[SMA6201_IO_BULK_WRITE] = "bulk_write",
+};
+
+static int sma6201_io_hist_bucket(s64 time_ns)
+{
+	s64 time_us = div_s64(time_ns, NSEC_PER_USEC);
+
+	if (time_us <= 0)
+		return 0;
+
+	return min_t(int, ilog2(time_us) + 1, SMA6201_IO_HIST_BUCKETS - 1);
+}
+
+static bool sma6201_io_bus_read(struct sma6201_priv *sma6201,
+		unsigned int reg)
+{
+	return sma6201_volatile_register(sma6201->dev, reg);
+}
+
+static bool sma6201_io_bus_write(struct sma6201_priv *sma6201)
+{
+	return !sma6201->cache_deferred;
+}
+
+/* Count the bus reads/writes of count registers from reg, io locked */
+static void sma6201_io_count_regs(struct sma6201_io_stats *io,
+		unsigned int reg, size_t count, bool read, bool write)
+{
+	size_t i;
+
+	for (i = 0; i < count && reg + i <= SMA6201_EQ_BANK_MAX; i++) {
+		if (read)
+			io->reads[reg + i]++;
+		if (write)
+			io->writes[reg + i]++;
+	}
+}
+
+/* Charge one call of xfers bus transfers to site, io locked */
+static void sma6201_io_charge(struct sma6201_io_stats *io,
+		enum sma6201_io_site site, enum sma6201_io_op op,
+		unsigned int xfers, s64 time_ns)
+{
+	struct sma6201_io_site_stats *stats = &io->site[site];
+
+	if (xfers)
+		io->hist[op][sma6201_io_hist_bucket(time_ns)]++;
+
+	stats->calls++;
+	stats->xfers += xfers;
+	stats->time_ns += time_ns;
+	if (time_ns > stats->max_ns)
+		stats->max_ns = time_ns;
+}
+
+/* val is the value read or written, the first one of a bulk access */
+static void sma6201_io_account(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, enum sma6201_io_op op,
+		unsigned int reg, unsigned int val, size_t count,
+		bool read, bool write, ktime_t start, int ret)
+{
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+	s64 time_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	trace_sma6201_io(sma6201->dev, sma6201_io_site_names[site],
+			sma6201_io_op_names[op], reg, val, count,
+			time_ns, ret);
+
+	spin_lock(&io->lock);
+	sma6201_io_count_regs(io, reg, count, read, write);
+	sma6201_io_charge(io, site, op, read + write, time_ns);
+	spin_unlock(&io->lock);
+}
+
+static int sma6201_io_read(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, unsigned int reg, unsigned int *val)
+{
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = regmap_read(sma6201->regmap, reg, val);
+	sma6201_io_account(sma6201, site, SMA6201_IO_READ, reg,
+			ret ? 0 : *val, 1, sma6201_io_bus_read(sma6201, reg),
+			false, start, ret);
+
+	return ret;
+}
+
+static int sma6201_io_write(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, unsigned int reg, unsigned int val)
+{
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = regmap_write(sma6201->regmap, reg, val);
+	sma6201_io_account(sma6201, site, SMA6201_IO_WRITE, reg, val, 1,
+			false, sma6201_io_bus_write(sma6201), start, ret);
+
+	return ret;
+}
+
+/* A register already at the requested value is not written again */
+static int sma6201_io_update_bits_check(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, unsigned int reg,
+		unsigned int mask, unsigned int val, bool *change)
+{
+	ktime_t start = ktime_get();
+	bool changed = false;
+	int ret;
+
+	ret = regmap_update_bits_check(sma6201->regmap, reg, mask, val,
+			&changed);
+	sma6201_io_account(sma6201, site, SMA6201_IO_UPDATE_BITS, reg,
+			val & mask, 1, sma6201_io_bus_read(sma6201, reg),
+			changed && sma6201_io_bus_write(sma6201), start, ret);
+	if (change)
+		*change = changed;
+
+	return ret;
+}
+
+static int sma6201_io_update_bits(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, unsigned int reg,
+		unsigned int mask, unsigned int val)
+{
+	return sma6201_io_update_bits_check(sma6201, site, reg, mask, val,
+			NULL);
+}
+
+static int sma6201_io_raw_write(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, unsigned int reg,
+		const void *val, size_t len)
+{
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = regmap_raw_write(sma6201->regmap, reg, val, len);
+	sma6201_io_account(sma6201, site, SMA6201_IO_BULK_WRITE, reg,
+			len ? *(const u8 *)val : 0, len,
+			false, sma6201_io_bus_write(sma6201), start, ret);
+
+	return ret;
+}
+
+static int sma6201_io_bulk_read(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, unsigned int reg,
+		void *val, size_t count)
+{
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = regmap_bulk_read(sma6201->regmap, reg, val, count);
+	sma6201_io_account(sma6201, site, SMA6201_IO_BULK_READ, reg,
+			(!ret && count) ? *(u8 *)val : 0, count,
+			sma6201_io_bus_read(sma6201, reg), false, start, ret);
+
+	return ret;
+}
+
+/* One bus transfer per register, the I2C bus has no multi write.
+ * bypassed writes the chip only, whatever the cache mode.
+ */
+static int sma6201_io_multi_reg_write(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, const struct reg_sequence *regs,
+		int num, bool bypassed)
+{
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+	bool write = bypassed || sma6201_io_bus_write(sma6201);
+	ktime_t start = ktime_get();
+	s64 time_ns;
+	int i, ret;
+
+	if (bypassed)
+		ret = regmap_multi_reg_write_bypassed(sma6201->regmap,
+				regs, num);
+	else
+		ret = regmap_multi_reg_write(sma6201->regmap, regs, num);
+	time_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	trace_sma6201_io(sma6201->dev, sma6201_io_site_names[site],
+			sma6201_io_op_names[SMA6201_IO_BULK_WRITE],
+			num ? regs[0].reg : 0, num ? regs[0].def : 0, num,
+			time_ns, ret);
+
+	spin_lock(&io->lock);
+	for (i = 0; i < num; i++)
+		sma6201_io_count_regs(io, regs[i].reg, 1, false, write);
+	sma6201_io_charge(io, site, SMA6201_IO_BULK_WRITE,
+			write ? num : 0, time_ns);
+	spin_unlock(&io->lock);
+
+	return ret;
+}
+
+/* regmap_read_poll_timeout() through sma6201_io_read() */
+#define sma6201_io_read_poll_timeout(sma6201, site, reg, val, cond, \
+		sleep_us, timeout_us) \
+({ \
+	ktime_t __timeout = ktime_add_us(ktime_get(), timeout_us); \
+	int __ret; \
+	for (;;) { \
+		__ret = sma6201_io_read(sma6201, site, reg, &(val)); \
+		if (__ret || (cond)) \
+			break; \
+		if (ktime_compare(ktime_get(), __timeout) > 0) { \
+			__ret = sma6201_io_read(sma6201, site, reg, &(val)); \
+			if (!__ret && !(cond)) \
+				__ret = -ETIMEDOUT; \
+			break; \
+		} \
+		usleep_range(((sleep_us) >> 2) + 1, sleep_us); \
+	} \
+	__ret; \
+})
+
+/* Register update transaction
+ * Masked updates are collected between begin and commit into a table
+ * the caller sizes. Consecutive updates of one register are merged,
+ * the write order of the caller is kept. Commit writes only the final
+ * values that differ from the register cache and merges runs of
+ * adjacent registers into bursts.
+ */
+#define SMA6201_TXN_MAX_BURST	8
+
+struct sma6201_txn_reg {
+	u16 reg;
+	u8 mask;
+	u8 val;
+	u8 fin;
+	bool changed;
+};
+
+struct sma6201_txn {
+	struct sma6201_priv *sma6201;
+	enum sma6201_io_site site;
+	const char *name;
+	struct sma6201_txn_reg *regs;
+	int max;
+	int num;
+	int err;
+};
+
+static void sma6201_txn_begin(struct sma6201_priv *sma6201,
+		struct sma6201_txn *txn, enum sma6201_io_site site,
+		const char *name, struct sma6201_txn_reg *regs, int max)
+{
+	txn->sma6201 = sma6201;
+	txn->site = site;
+	txn->name = name;
+	txn->regs = regs;
+	txn->max = max;
+	txn->num = 0;
+	txn->err = 0;
+}
+
+static void sma6201_txn_update(struct sma6201_txn *txn,
+		unsigned int reg, unsigned int mask, unsigned int val)
+{
+	struct sma6201_txn_reg *entry;
+
+	if (txn->num && txn->regs[txn->num - 1].reg == reg) {
+		entry = &txn->regs[txn->num - 1];
+	} else {
+		if (txn->num == txn->max) {
+			dev_err(txn->sma6201->dev,
+				"%s : %s transaction is full, register: %x\n",
+					__func__, txn->name, reg);
+			txn->err = -ENOSPC;
+			return;
+		}
+		entry = &txn->regs[txn->num++];
+		entry->reg = reg;
+		entry->mask = 0;
+		entry->val = 0;
+	}
+
+	entry->val = (entry->val & ~mask) | (val & mask);
+	entry->mask |= mask;
+}
+
+/* Return the number of bus writes issued or a negative error code */
+static int sma6201_txn_commit(struct sma6201_txn *txn)
+{
+	struct sma6201_priv *sma6201 = txn->sma6201;
+	struct sma6201_txn_reg *regs = txn->regs;
+	unsigned int cur;
+	u8 buf[SMA6201_TXN_MAX_BURST];
+	int i, j, first, last, k, ret, writes = 0;
+
+	if (txn->err)
+		return txn->err;
+
+	/* Final values from the register cache or from an earlier
+	 * update of the same register, no I2C access
+	 */
+	for (i = 0; i < txn->num; i++) {
+		for (j = i - 1; j >= 0 && regs[j].reg != regs[i].reg; j--)
+			;
+		if (j >= 0) {
+			cur = regs[j].fin;
+		} else {
+			ret = sma6201_io_read(sma6201, txn->site, regs[i].reg,
+					&cur);
+			if (ret)
+				return ret;
+		}
+		regs[i].fin = (cur & ~regs[i].mask) | regs[i].val;
+		regs[i].changed = (regs[i].fin != cur);
+	}
+
+	for (i = 0; i < txn->num; i = j) {
+		/* Run of ascending adjacent registers, one burst at most */
+		for (j = i + 1; j < txn->num &&
+			j - i < SMA6201_TXN_MAX_BURST &&
+			regs[j].reg == regs[j - 1].reg + 1; j++)
+			;
+
+		/* Trim unchanged registers at both ends of the run */
+		for (first = i; first < j && !regs[first].changed; first++)
+			;
+		if (first == j)
+			continue;
+		for (last = j - 1; !regs[last].changed; last--)
+			;
+
+		if (first == last) {
+			ret = sma6201_io_write(sma6201, txn->site,
+					regs[first].reg, regs[first].fin);
+		} else {
+			for (k = first; k <= last; k++)
+				buf[k - first] = regs[k].fin;
+			ret = sma6201_io_raw_write(sma6201, txn->site,
+					regs[first].reg, buf,
+					last - first + 1);
+		}
+		if (ret) {
+			dev_err(sma6201->dev,
+				"%s : %s commit fail, register: %x ret: %d\n",
+				__func__, txn->name, regs[first].reg, ret);
+			return ret;
+		}
+		writes++;
+	}
+
+	dev_dbg(sma6201->dev, "%s : %s %d registers, %d writes\n",
+			__func__, txn->name, txn->num, writes);
+
+	return writes;
+}
+
+static const char * const sma6201_phase_names[SMA6201_PHASE_MAX] = {
+	[SMA6201_PHASE_PROBE] = "probe",
+	[SMA6201_PHASE_RESET] = "reset",
+	[SMA6201_PHASE_TUNING] = "tuning",
+	[SMA6201_PHASE_HW_PARAMS] = "hw_params",
+	[SMA6201_PHASE_SETUP_PLL] = "setup_pll",
+	[SMA6201_PHASE_STARTUP] = "startup",
+	[SMA6201_PHASE_SHUTDOWN] = "shutdown",
+	[SMA6201_PHASE_STANDBY] = "standby",
+	[SMA6201_PHASE_POWER_DOWN] = "power_down",
+	[SMA6201_PHASE_RESUME] = "resume",
+	[SMA6201_PHASE_ADC_FEEDBACK] = "adc_feedback",
+};
+
+/* Record a phase started at start, always process context */
+static void sma6201_phase_end(struct sma6201_priv *sma6201,
+		enum sma6201_phase phase, ktime_t start)
+{
+	struct sma6201_phase_stats *stats = &sma6201->phases[phase];
+	s64 duration_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	trace_sma6201_phase(sma6201->dev, sma6201_phase_names[phase],
+			duration_ns);
+
+	spin_lock(&sma6201->phase_lock);
+	stats->samples_us[stats->head] = min_t(s64,
+			div_s64(duration_ns, NSEC_PER_USEC), U32_MAX);
+	stats->head = (stats->head + 1) % SMA6201_PHASE_WINDOW;
+	stats->count++;
+	spin_unlock(&sma6201->phase_lock);
+}
+
+static const struct {
+	unsigned int reg;
+	unsigned int mask;
+} sma6201_shadow_regs[SMA6201_SHADOW_MAX] = {
+	[SMA6201_SHADOW_POWER] = { SMA6201_00_SYSTEM_CTRL, POWER_MASK },
+	[SMA6201_SHADOW_MUTE] = { SMA6201_0E_MUTE_VOL_CTRL, SPK_MUTE_MASK },
+	[SMA6201_SHADOW_SPK_MODE] = { SMA6201_10_SYSTEM_CTRL1, SPK_MODE_MASK },
+	[SMA6201_SHADOW_TONE_ON] = { SMA6201_A8_TONE_GENERATOR, TONE_ON_MASK },
+	[SMA6201_SHADOW_TONE_VOL] = { SMA6201_A9_TONE_FINE_VOL, TONE_VOL_MASK },
+	[SMA6201_SHADOW_DIS_IRQ] = { SMA6201_AE_TOP_MAN4, DIS_IRQ_MASK },
+	[SMA6201_SHADOW_PLL_LDO_BYP] = { SMA6201_AC_PLL_CTRL,
+					PLL_LDO_BYP_MASK },
+};
+
+/* Set a power state field, a field already in the requested state
+ * costs neither a bus nor a register cache access.
+ * Returns 1 if the register changed, 0 if not.
+ */
+static int sma6201_shadow_update(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, enum sma6201_shadow_field field,
+		unsigned int val)
+{
+	struct sma6201_shadow *shadow = &sma6201->shadow;
+	bool changed = false;
+	int ret;
+
+	mutex_lock(&shadow->lock);
+
+	if ((shadow->valid & BIT(field)) && shadow->val[field] == val) {
+		mutex_unlock(&shadow->lock);
+		return 0;
+	}
+
+	ret = sma6201_io_update_bits_check(sma6201, site,
+			sma6201_shadow_regs[field].reg,
+			sma6201_shadow_regs[field].mask, val, &changed);
+	if (ret) {
+		shadow->valid &= ~BIT(field);
+	} else {
+		shadow->val[field] = val;
+		shadow->valid |= BIT(field);
+	}
+
+	mutex_unlock(&shadow->lock);
+
+	return ret ? ret : changed;
+}
+
+/* Writes outside sma6201_shadow_update(mixer controls, scenes, reset)
+ * drop the shadow, the next transition reads the register cache again
+ */
+static void sma6201_shadow_invalidate(struct sma6201_priv *sma6201)
+{
+	mutex_lock(&sma6201->shadow.lock);
+	sma6201->shadow.valid = 0;
+	mutex_unlock(&sma6201->shadow.lock);
+}
+
+/* snd_soc_put_volsw for controls on the shadowed fields */
+static int sma6201_shadow_put_volsw(struct snd_kcontrol *kcontrol,
+		struct snd_ctl_elem_value *ucontrol)
+{
+	struct snd_soc_component *component =
+		snd_soc_kcontrol_component(kcontrol);
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	int ret;
+
+	ret = snd_soc_put_volsw(kcontrol, ucontrol);
+	sma6201_shadow_invalidate(sma6201);
+
+	return ret;
+}
+
 /* DB scale conversion of speaker volume(mute:-60dB) */
 static const DECLARE_TLV_DB_SCALE(sma6201_spk_tlv, -6000, 50, 0);
 
@@ -492,21 +1223,17 @@ static int bytes_ext_get(struct snd_kcontrol *kcontrol,
 		snd_soc_kcontrol_component(kcontrol);
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	struct soc_bytes_ext *params = (void *)kcontrol->private_value;
-	unsigned int i, reg_val;
-	u8 *val;
-
-	val = (u8 *)ucontrol->value.bytes.data;
-	for (i = 0; i < params->max; i++) {
-		regmap_read(sma6201->regmap, reg + i, &reg_val);
-		if (sizeof(reg_val) > 2)
-			reg_val = cpu_to_le32(reg_val);
-		else
-			reg_val = cpu_to_le16(reg_val);
-		memcpy(val + i, &reg_val, sizeof(u8));
-	}
+	int ret;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ1_BANK_SEL);
+	/* auto-increment burst read, served from cache if not volatile */
+	ret = sma6201_io_bulk_read(sma6201, SMA6201_IO_KCONTROL, reg,
+			ucontrol->value.bytes.data, params->max);
+	if (ret) {
+		dev_err(component->dev,
+			"configuration fail, register: %x ret: %d\n",
+			reg, ret);
+		return ret;
+	}
 
 	return 0;
 }
@@ -518,30 +1245,18 @@ static int bytes_ext_put(struct snd_kcontrol *kcontrol,
 		snd_soc_kcontrol_component(kcontrol);
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	struct soc_bytes_ext *params = (void *)kcontrol->private_value;
-	void *data;
-	u8 *val;
-	int i, ret;
-
-	data = kmemdup(ucontrol->value.bytes.data,
-			params->max, GFP_KERNEL | GFP_DMA);
-	if (!data)
-		return -ENOMEM;
+	int ret;
 
-	val = (u8 *)data;
-	for (i = 0; i < params->max; i++) {
-		ret = regmap_write(sma6201->regmap, reg + i, *(val + i));
-		if (ret) {
-			dev_err(component->dev,
-				"configuration fail, register: %x ret: %d\n",
-				reg + i, ret);
-			kfree(data);
-			return ret;
-		}
+	/* auto-increment burst write in a single I2C transaction */
+	ret = sma6201_io_raw_write(sma6201, SMA6201_IO_KCONTROL, reg,
+			ucontrol->value.bytes.data, params->max);
+	sma6201_shadow_invalidate(sma6201);
+	if (ret) {
+		dev_err(component->dev,
+			"configuration fail, register: %x ret: %d\n",
+			reg, ret);
+		return ret;
 	}
-	kfree(data);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ1_BANK_SEL);
 
 	return 0;
 }
@@ -625,7 +1340,8 @@ static int sma6201_clk_system_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_00_SYSTEM_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_00_SYSTEM_CTRL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xE0) >> 5);
 
 	return 0;
@@ -642,8 +1358,8 @@ static int sma6201_clk_system_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_00_SYSTEM_CTRL,
-			0xE0, (sel << 5));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_00_SYSTEM_CTRL, 0xE0, (sel << 5));
 
 	return 0;
 }
@@ -666,7 +1382,8 @@ static int sma6201_input_format_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_01_INPUT1_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_01_INPUT1_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x70) >> 4);
 
 	return 0;
@@ -683,8 +1400,8 @@ static int sma6201_input_format_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
-			0x70, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_01_INPUT1_CTRL1, 0x70, (sel << 4));
 
 	return 0;
 }
@@ -731,7 +1448,8 @@ static int sma6201_port_config_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_09_OUTPUT_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_09_OUTPUT_CTRL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x60) >> 5);
 
 	return 0;
@@ -748,7 +1466,7 @@ static int sma6201_port_config_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
 		SMA6201_09_OUTPUT_CTRL, 0x60, (sel << 5));
 
 	return 0;
@@ -770,7 +1488,8 @@ static int sma6201_port_out_format_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_09_OUTPUT_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_09_OUTPUT_CTRL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x18) >> 3);
 
 	return 0;
@@ -787,7 +1506,7 @@ static int sma6201_port_out_format_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
 		SMA6201_09_OUTPUT_CTRL, 0x18, (sel << 3));
 
 	return 0;
@@ -812,7 +1531,8 @@ static int sma6201_port_out_sel_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_09_OUTPUT_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_09_OUTPUT_CTRL,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x07);
 
 	return 0;
@@ -829,7 +1549,8 @@ static int sma6201_port_out_sel_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_09_OUTPUT_CTRL, 0x07, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_09_OUTPUT_CTRL, 0x07, sel);
 
 	return 0;
 }
@@ -868,7 +1589,8 @@ static int sma6201_attack_lvl_1_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_0D_CLASS_H_CTRL_LVL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0D_CLASS_H_CTRL_LVL1, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -885,8 +1607,8 @@ static int sma6201_attack_lvl_1_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_0D_CLASS_H_CTRL_LVL1,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0D_CLASS_H_CTRL_LVL1, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -909,7 +1631,8 @@ static int sma6201_release_time_1_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_0D_CLASS_H_CTRL_LVL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0D_CLASS_H_CTRL_LVL1, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -926,8 +1649,8 @@ static int sma6201_release_time_1_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_0D_CLASS_H_CTRL_LVL1,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x0F, sel);
 
 	return 0;
 }
@@ -949,7 +1672,8 @@ static int sma6201_vol_slope_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_0E_MUTE_VOL_CTRL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -966,7 +1690,7 @@ static int sma6201_vol_slope_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
 		SMA6201_0E_MUTE_VOL_CTRL, 0xC0, (sel << 6));
 
 	return 0;
@@ -989,7 +1713,8 @@ static int sma6201_mute_slope_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_0E_MUTE_VOL_CTRL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x30) >> 4);
 
 	return 0;
@@ -1006,7 +1731,7 @@ static int sma6201_mute_slope_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
 		SMA6201_0E_MUTE_VOL_CTRL, 0x30, (sel << 4));
 
 	return 0;
@@ -1031,7 +1756,8 @@ static int sma6201_attack_lvl_2_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_0F_CLASS_H_CTRL_LVL2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0F_CLASS_H_CTRL_LVL2, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -1048,8 +1774,8 @@ static int sma6201_attack_lvl_2_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_0F_CLASS_H_CTRL_LVL2,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0F_CLASS_H_CTRL_LVL2, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -1072,7 +1798,8 @@ static int sma6201_release_time_2_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_0F_CLASS_H_CTRL_LVL2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0F_CLASS_H_CTRL_LVL2, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -1089,8 +1816,8 @@ static int sma6201_release_time_2_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_0F_CLASS_H_CTRL_LVL2,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x0F, sel);
 
 	return 0;
 }
@@ -1112,7 +1839,8 @@ static int sma6201_spkmode_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_10_SYSTEM_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_10_SYSTEM_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x1C) >> 2);
 
 	return 0;
@@ -1129,23 +1857,26 @@ static int sma6201_spkmode_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
 		SMA6201_10_SYSTEM_CTRL1, 0x1C, (sel << 2));
+	sma6201_shadow_invalidate(sma6201);
 
 	if (sel == (SPK_MONO >> 2)) {
 		sma6201->stereo_two_chip = false;
 		dev_info(component->dev, "%s : Mono for one chip solution\n",
 					__func__);
 		if (sma6201->src_bypass == true)
-			regmap_update_bits(sma6201->regmap, SMA6201_A3_TOP_MAN2,
-				BP_SRC_MIX_MASK, BP_SRC_MIX_MONO);
+			sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+				SMA6201_A3_TOP_MAN2, BP_SRC_MIX_MASK,
+				BP_SRC_MIX_MONO);
 	} else if (sel == (SPK_STEREO >> 2)) {
 		sma6201->stereo_two_chip = true;
 		dev_info(component->dev, "%s : Stereo for two chip solution\n",
 					__func__);
-		regmap_update_bits(sma6201->regmap, SMA6201_A3_TOP_MAN2,
-			BP_SRC_MIX_MASK, BP_SRC_MIX_NORMAL);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A3_TOP_MAN2, BP_SRC_MIX_MASK,
+			BP_SRC_MIX_NORMAL);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
 			SMA6201_11_SYSTEM_CTRL2, MONOMIX_MASK, MONOMIX_OFF);
 	}
 
@@ -1168,7 +1899,8 @@ static int sma6201_input_gain_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_12_SYSTEM_CTRL3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_12_SYSTEM_CTRL3,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -1185,8 +1917,8 @@ static int sma6201_input_gain_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_12_SYSTEM_CTRL3,
-			0xC0, (sel << 6));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_12_SYSTEM_CTRL3, 0xC0, (sel << 6));
 
 	return 0;
 }
@@ -1206,7 +1938,8 @@ static int sma6201_input_r_gain_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_12_SYSTEM_CTRL3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_12_SYSTEM_CTRL3,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x30) >> 4);
 
 	return 0;
@@ -1223,8 +1956,8 @@ static int sma6201_input_r_gain_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_12_SYSTEM_CTRL3,
-			0x30, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_12_SYSTEM_CTRL3, 0x30, (sel << 4));
 
 	return 0;
 }
@@ -1244,7 +1977,8 @@ static int sma6201_fdpec_i_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_13_FDPEC_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_13_FDPEC_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x18) >> 3);
 
 	return 0;
@@ -1261,8 +1995,8 @@ static int sma6201_fdpec_i_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_13_FDPEC_CTRL1,
-			0x18, (sel << 3));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_13_FDPEC_CTRL1, 0x18, (sel << 3));
 
 	return 0;
 }
@@ -1283,7 +2017,8 @@ static int fdpec_gain_control_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_13_FDPEC_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_13_FDPEC_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x07);
 
 	return 0;
@@ -1300,8 +2035,8 @@ static int fdpec_gain_control_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_13_FDPEC_CTRL1,
-			0x07, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_13_FDPEC_CTRL1, 0x07, sel);
 
 	return 0;
 }
@@ -1322,7 +2057,8 @@ static int sma6201_spk_hysfb_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_14_MODULATOR, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_14_MODULATOR,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -1339,8 +2075,8 @@ static int sma6201_spk_hysfb_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_14_MODULATOR,
-			0xC0, (sel << 6));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_14_MODULATOR, 0xC0, (sel << 6));
 
 	return 0;
 }
@@ -1441,7 +2177,8 @@ static int sma6201_attack_lvl_3_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_28_CLASS_H_CTRL_LVL3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_28_CLASS_H_CTRL_LVL3, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -1458,8 +2195,8 @@ static int sma6201_attack_lvl_3_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_28_CLASS_H_CTRL_LVL3,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_28_CLASS_H_CTRL_LVL3, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -1482,7 +2219,8 @@ static int sma6201_release_time_3_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_28_CLASS_H_CTRL_LVL3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_28_CLASS_H_CTRL_LVL3, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -1499,8 +2237,8 @@ static int sma6201_release_time_3_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_28_CLASS_H_CTRL_LVL3,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_28_CLASS_H_CTRL_LVL3, 0x0F, sel);
 
 	return 0;
 }
@@ -1524,7 +2262,8 @@ static int sma6201_attack_lvl_4_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_29_CLASS_H_CTRL_LVL4, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_29_CLASS_H_CTRL_LVL4, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -1541,8 +2280,8 @@ static int sma6201_attack_lvl_4_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_29_CLASS_H_CTRL_LVL4,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_29_CLASS_H_CTRL_LVL4, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -1565,7 +2304,8 @@ static int sma6201_release_time_4_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_29_CLASS_H_CTRL_LVL4, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_29_CLASS_H_CTRL_LVL4, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -1582,8 +2322,8 @@ static int sma6201_release_time_4_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_29_CLASS_H_CTRL_LVL4,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_29_CLASS_H_CTRL_LVL4, 0x0F, sel);
 
 	return 0;
 }
@@ -1607,7 +2347,8 @@ static int sma6201_attack_lvl_5_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_2A_CLASS_H_CTRL_LVL5, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_2A_CLASS_H_CTRL_LVL5, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -1624,8 +2365,8 @@ static int sma6201_attack_lvl_5_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_2A_CLASS_H_CTRL_LVL5,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_2A_CLASS_H_CTRL_LVL5, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -1648,7 +2389,8 @@ static int sma6201_release_time_5_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_2A_CLASS_H_CTRL_LVL5, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_2A_CLASS_H_CTRL_LVL5, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -1665,8 +2407,8 @@ static int sma6201_release_time_5_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_2A_CLASS_H_CTRL_LVL5,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_2A_CLASS_H_CTRL_LVL5, 0x0F, sel);
 
 	return 0;
 }
@@ -1688,7 +2430,8 @@ static int sma6201_otp_mode_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_36_PROTECTION, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_36_PROTECTION,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x03);
 
 	return 0;
@@ -1705,7 +2448,8 @@ static int sma6201_otp_mode_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_36_PROTECTION, 0x03, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_36_PROTECTION, 0x03, sel);
 
 	return 0;
 }
@@ -1753,200 +2497,150 @@ static int test_mode_put(struct snd_kcontrol *kcontrol,
 static int eq1_ctrl_band1_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_40_EQ_CTRL1);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_40_EQ_CTRL1));
 }
 
 static int eq1_ctrl_band1_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_40_EQ_CTRL1);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_40_EQ_CTRL1));
 }
 
 /* EQ1 Band2 */
 static int eq1_ctrl_band2_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_4F_EQ_CTRL16);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_4F_EQ_CTRL16));
 }
 
 static int eq1_ctrl_band2_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_4F_EQ_CTRL16);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_4F_EQ_CTRL16));
 }
 
 /* EQ1 Band3 */
 static int eq1_ctrl_band3_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_5E_EQ_CTRL31);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_5E_EQ_CTRL31));
 }
 
 static int eq1_ctrl_band3_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_5E_EQ_CTRL31);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_5E_EQ_CTRL31));
 }
 
 /* EQ1 Band4 */
 static int eq1_ctrl_band4_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_6D_EQ_CTRL46);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_6D_EQ_CTRL46));
 }
 
 static int eq1_ctrl_band4_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_6D_EQ_CTRL46);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_6D_EQ_CTRL46));
 }
 
 /* EQ1 Band5 */
 static int eq1_ctrl_band5_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_7C_EQ_CTRL61);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_7C_EQ_CTRL61));
 }
 
 static int eq1_ctrl_band5_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_7C_EQ_CTRL61);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ1_REG(SMA6201_7C_EQ_CTRL61));
 }
 
 /* EQ2 Band1 */
 static int eq2_ctrl_band1_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_40_EQ_CTRL1);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_40_EQ_CTRL1));
 }
 
 static int eq2_ctrl_band1_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_40_EQ_CTRL1);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_40_EQ_CTRL1));
 }
 
 /* EQ2 Band2 */
 static int eq2_ctrl_band2_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_4F_EQ_CTRL16);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_4F_EQ_CTRL16));
 }
 
 static int eq2_ctrl_band2_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_4F_EQ_CTRL16);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_4F_EQ_CTRL16));
 }
 
 /* EQ2 Band3 */
 static int eq2_ctrl_band3_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_5E_EQ_CTRL31);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_5E_EQ_CTRL31));
 }
 
 static int eq2_ctrl_band3_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_5E_EQ_CTRL31);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_5E_EQ_CTRL31));
 }
 
 /* EQ2 Band4 */
 static int eq2_ctrl_band4_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_6D_EQ_CTRL46);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_6D_EQ_CTRL46));
 }
 
 static int eq2_ctrl_band4_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_6D_EQ_CTRL46);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_6D_EQ_CTRL46));
 }
 
 /* EQ2 Band5 */
 static int eq2_ctrl_band5_get(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_get(kcontrol, ucontrol, SMA6201_7C_EQ_CTRL61);
+	return bytes_ext_get(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_7C_EQ_CTRL61));
 }
 
 static int eq2_ctrl_band5_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
-	struct snd_soc_component *component =
-		snd_soc_kcontrol_component(kcontrol);
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-
-	return bytes_ext_put(kcontrol, ucontrol, SMA6201_7C_EQ_CTRL61);
+	return bytes_ext_put(kcontrol, ucontrol,
+			SMA6201_EQ2_REG(SMA6201_7C_EQ_CTRL61));
 }
 
 
@@ -1982,7 +2676,8 @@ static int sma6201_attack_lvl_6_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_90_CLASS_H_CTRL_LVL6, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_90_CLASS_H_CTRL_LVL6, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -1999,8 +2694,8 @@ static int sma6201_attack_lvl_6_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_90_CLASS_H_CTRL_LVL6,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_90_CLASS_H_CTRL_LVL6, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -2023,7 +2718,8 @@ static int sma6201_release_time_6_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_90_CLASS_H_CTRL_LVL6, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_90_CLASS_H_CTRL_LVL6, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -2040,8 +2736,8 @@ static int sma6201_release_time_6_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_90_CLASS_H_CTRL_LVL6,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_90_CLASS_H_CTRL_LVL6, 0x0F, sel);
 
 	return 0;
 }
@@ -2065,7 +2761,8 @@ static int sma6201_attack_lvl_7_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_91_CLASS_H_CTRL_LVL7, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_91_CLASS_H_CTRL_LVL7, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -2082,8 +2779,8 @@ static int sma6201_attack_lvl_7_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_91_CLASS_H_CTRL_LVL7,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_91_CLASS_H_CTRL_LVL7, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -2106,7 +2803,8 @@ static int sma6201_release_time_7_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_91_CLASS_H_CTRL_LVL7, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_91_CLASS_H_CTRL_LVL7, &val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -2123,8 +2821,8 @@ static int sma6201_release_time_7_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_91_CLASS_H_CTRL_LVL7,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_91_CLASS_H_CTRL_LVL7, 0x0F, sel);
 
 	return 0;
 }
@@ -2145,7 +2843,8 @@ static int sma6201_fdpec_gain_trm_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_92_FDPEC_CTRL2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_92_FDPEC_CTRL2,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -2162,8 +2861,8 @@ static int sma6201_fdpec_gain_trm_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_92_FDPEC_CTRL2,
-			0xC0, (sel << 6));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_92_FDPEC_CTRL2, 0xC0, (sel << 6));
 
 	return 0;
 }
@@ -2182,7 +2881,8 @@ static int sma6201_diffamp_i_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_92_FDPEC_CTRL2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_92_FDPEC_CTRL2,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x06) >> 1);
 
 	return 0;
@@ -2199,8 +2899,8 @@ static int sma6201_diffamp_i_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_92_FDPEC_CTRL2,
-			0x06, (sel << 1));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_92_FDPEC_CTRL2, 0x06, (sel << 1));
 
 	return 0;
 }
@@ -2223,7 +2923,8 @@ static int sma6201_trm_vref_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_93_BOOST_CTRL0, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_93_BOOST_CTRL0,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -2240,8 +2941,8 @@ static int sma6201_trm_vref_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_93_BOOST_CTRL0,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_93_BOOST_CTRL0, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -2262,7 +2963,8 @@ static int sma6201_trm_vbst1_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_93_BOOST_CTRL0, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_93_BOOST_CTRL0,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -2281,8 +2983,8 @@ static int sma6201_trm_vbst1_put(struct snd_kcontrol *kcontrol,
 
 	dev_info(component->dev, "%s : Trimming of boost output voltage %dV\n",
 				__func__, (sel + 6));
-	regmap_update_bits(sma6201->regmap, SMA6201_93_BOOST_CTRL0,
-				0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+				SMA6201_93_BOOST_CTRL0, 0x0F, sel);
 
 	return 0;
 }
@@ -2302,7 +3004,8 @@ static int sma6201_trm_comp2_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_94_BOOST_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_94_BOOST_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -2319,8 +3022,8 @@ static int sma6201_trm_comp2_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_94_BOOST_CTRL1,
-			0xC0, (sel << 6));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_94_BOOST_CTRL1, 0xC0, (sel << 6));
 
 	return 0;
 }
@@ -2340,7 +3043,8 @@ static int sma6201_trm_osc_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_94_BOOST_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_94_BOOST_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x38) >> 3);
 
 	return 0;
@@ -2357,8 +3061,8 @@ static int sma6201_trm_osc_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_94_BOOST_CTRL1,
-			0x38, (sel << 3));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_94_BOOST_CTRL1, 0x38, (sel << 3));
 
 	return 0;
 }
@@ -2378,7 +3082,8 @@ static int sma6201_trm_rmp_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_94_BOOST_CTRL1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_94_BOOST_CTRL1,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x07);
 
 	return 0;
@@ -2395,8 +3100,8 @@ static int sma6201_trm_rmp_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_94_BOOST_CTRL1,
-			0x07, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_94_BOOST_CTRL1, 0x07, sel);
 
 	return 0;
 }
@@ -2417,7 +3122,8 @@ static int sma6201_trm_ocl_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_95_BOOST_CTRL2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_95_BOOST_CTRL2,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x70) >> 4);
 
 	return 0;
@@ -2434,8 +3140,8 @@ static int sma6201_trm_ocl_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_95_BOOST_CTRL2,
-			0x70, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_95_BOOST_CTRL2, 0x70, (sel << 4));
 
 	return 0;
 }
@@ -2459,7 +3165,8 @@ static int sma6201_trm_comp_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_95_BOOST_CTRL2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_95_BOOST_CTRL2,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x0F);
 
 	return 0;
@@ -2476,8 +3183,8 @@ static int sma6201_trm_comp_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_95_BOOST_CTRL2,
-			0x0F, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_95_BOOST_CTRL2, 0x0F, sel);
 
 	return 0;
 }
@@ -2500,7 +3207,8 @@ static int sma6201_trm_dt_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_96_BOOST_CTRL3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_96_BOOST_CTRL3,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xF0) >> 4);
 
 	return 0;
@@ -2517,8 +3225,8 @@ static int sma6201_trm_dt_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_96_BOOST_CTRL3,
-			0xF0, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_96_BOOST_CTRL3, 0xF0, (sel << 4));
 
 	return 0;
 }
@@ -2537,7 +3245,8 @@ static int sma6201_trm_slw_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_96_BOOST_CTRL3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_96_BOOST_CTRL3,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x03);
 
 	return 0;
@@ -2554,8 +3263,8 @@ static int sma6201_trm_slw_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_96_BOOST_CTRL3,
-			0x03, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_96_BOOST_CTRL3, 0x03, sel);
 
 	return 0;
 }
@@ -2596,7 +3305,8 @@ static int sma6201_trm_vbst2_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_97_BOOST_CTRL4, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_97_BOOST_CTRL4,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xFC) >> 2);
 
 	return 0;
@@ -2613,8 +3323,8 @@ static int sma6201_trm_vbst2_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 63))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_97_BOOST_CTRL4,
-			0xFC, (sel << 2));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_97_BOOST_CTRL4, 0xFC, (sel << 2));
 
 	return 0;
 }
@@ -2633,7 +3343,8 @@ static int sma6201_trm_tmin_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_97_BOOST_CTRL4, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_97_BOOST_CTRL4,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x03);
 
 	return 0;
@@ -2650,8 +3361,8 @@ static int sma6201_trm_tmin_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_97_BOOST_CTRL4,
-			0x03, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_97_BOOST_CTRL4, 0x03, sel);
 
 	return 0;
 }
@@ -2672,7 +3383,8 @@ static int sma6201_adc_sr_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_98_GENERAL_SETTING, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_98_GENERAL_SETTING, &val);
 	ucontrol->value.integer.value[0] = ((val & 0x1C) >> 2);
 
 	return 0;
@@ -2689,8 +3401,8 @@ static int sma6201_adc_sr_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_98_GENERAL_SETTING,
-			0x1C, (sel << 2));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_98_GENERAL_SETTING, 0x1C, (sel << 2));
 
 	return 0;
 }
@@ -2723,7 +3435,8 @@ static int sma6201_pgavol_i_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_9C_VOLUME_PGA_ISENSE, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_9C_VOLUME_PGA_ISENSE, &val);
 	ucontrol->value.integer.value[0] = ((val & 0x38) >> 3);
 
 	return 0;
@@ -2740,8 +3453,8 @@ static int sma6201_pgavol_i_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_9C_VOLUME_PGA_ISENSE,
-			0x38, (sel << 3));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_9C_VOLUME_PGA_ISENSE, 0x38, (sel << 3));
 
 	return 0;
 }
@@ -2762,7 +3475,8 @@ static int sma6201_ptat_res_ctrl_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_9C_VOLUME_PGA_ISENSE, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_9C_VOLUME_PGA_ISENSE, &val);
 	ucontrol->value.integer.value[0] = (val & 0x07);
 
 	return 0;
@@ -2779,8 +3493,8 @@ static int sma6201_ptat_res_ctrl_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_9C_VOLUME_PGA_ISENSE,
-			0x07, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_9C_VOLUME_PGA_ISENSE, 0x07, sel);
 
 	return 0;
 }
@@ -2814,7 +3528,8 @@ static int sma6201_adc_sys_clk_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A0_ADC_MUTE_VOL_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A0_ADC_MUTE_VOL_CTRL, &val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -2831,8 +3546,8 @@ static int sma6201_adc_sys_clk_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A0_ADC_MUTE_VOL_CTRL,
-			0xC0, (sel << 6));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A0_ADC_MUTE_VOL_CTRL, 0xC0, (sel << 6));
 
 	return 0;
 }
@@ -2853,7 +3568,8 @@ static int sma6201_adc_mute_slope_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A0_ADC_MUTE_VOL_CTRL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A0_ADC_MUTE_VOL_CTRL, &val);
 	ucontrol->value.integer.value[0] = ((val & 0x18) >> 3);
 
 	return 0;
@@ -2870,8 +3586,8 @@ static int sma6201_adc_mute_slope_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A0_ADC_MUTE_VOL_CTRL,
-			0x18, (sel << 3));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A0_ADC_MUTE_VOL_CTRL, 0x18, (sel << 3));
 
 	return 0;
 }
@@ -2892,7 +3608,8 @@ static int sma6201_o_format_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A4_SDO_OUT_FMT, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A4_SDO_OUT_FMT,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xE0) >> 5);
 
 	return 0;
@@ -2909,8 +3626,8 @@ static int sma6201_o_format_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A4_SDO_OUT_FMT,
-			0xE0, (sel << 5));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A4_SDO_OUT_FMT, 0xE0, (sel << 5));
 
 	return 0;
 }
@@ -2929,7 +3646,8 @@ static int sma6201_sck_rate_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A4_SDO_OUT_FMT, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A4_SDO_OUT_FMT,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x18) >> 3);
 
 	return 0;
@@ -2946,8 +3664,8 @@ static int sma6201_sck_rate_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A4_SDO_OUT_FMT,
-			0x18, (sel << 3));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A4_SDO_OUT_FMT, 0x18, (sel << 3));
 
 	return 0;
 }
@@ -2966,7 +3684,8 @@ static int sma6201_wd_length_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A4_SDO_OUT_FMT, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A4_SDO_OUT_FMT,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x06) >> 1);
 
 	return 0;
@@ -2983,8 +3702,8 @@ static int sma6201_wd_length_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A4_SDO_OUT_FMT,
-			0x06, (sel << 1));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A4_SDO_OUT_FMT, 0x06, (sel << 1));
 
 	return 0;
 }
@@ -3006,7 +3725,7 @@ static int sma6201_tdm_slot1_rx_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A5_TDM1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A5_TDM1, &val);
 	ucontrol->value.integer.value[0] = ((val & 0x38) >> 3);
 
 	return 0;
@@ -3023,7 +3742,7 @@ static int sma6201_tdm_slot1_rx_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL, SMA6201_A5_TDM1,
 			0x38, (sel << 3));
 
 	return 0;
@@ -3045,7 +3764,7 @@ static int sma6201_tdm_slot2_rx_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A5_TDM1, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A5_TDM1, &val);
 	ucontrol->value.integer.value[0] = (val & 0x07);
 
 	return 0;
@@ -3062,7 +3781,7 @@ static int sma6201_tdm_slot2_rx_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL, SMA6201_A5_TDM1,
 			0x07, sel);
 
 	return 0;
@@ -3085,7 +3804,7 @@ static int sma6201_tdm_slot1_tx_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A6_TDM2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A6_TDM2, &val);
 	ucontrol->value.integer.value[0] = ((val & 0x38) >> 3);
 
 	return 0;
@@ -3102,7 +3821,7 @@ static int sma6201_tdm_slot1_tx_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL, SMA6201_A6_TDM2,
 			0x38, (sel << 3));
 
 	return 0;
@@ -3124,7 +3843,7 @@ static int sma6201_tdm_slot2_tx_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A6_TDM2, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A6_TDM2, &val);
 	ucontrol->value.integer.value[0] = (val & 0x07);
 
 	return 0;
@@ -3141,7 +3860,7 @@ static int sma6201_tdm_slot2_tx_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL, SMA6201_A6_TDM2,
 			0x07, sel);
 
 	return 0;
@@ -3163,7 +3882,8 @@ static int sma6201_test_clock_mon_time_sel_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A7_TOP_MAN3, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A7_TOP_MAN3,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0xC0) >> 6);
 
 	return 0;
@@ -3180,8 +3900,8 @@ static int sma6201_test_clock_mon_time_sel_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A7_TOP_MAN3,
-			0xC0, (sel << 6));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A7_TOP_MAN3, 0xC0, (sel << 6));
 
 	return 0;
 }
@@ -3203,7 +3923,8 @@ static int sma6201_tone_freq_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_A8_TONE_GENERATOR, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_A8_TONE_GENERATOR,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x1E) >> 1);
 
 	return 0;
@@ -3220,8 +3941,8 @@ static int sma6201_tone_freq_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 15))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A8_TONE_GENERATOR,
-			0x1E, (sel << 1));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_A8_TONE_GENERATOR, 0x1E, (sel << 1));
 
 	return 0;
 }
@@ -3282,7 +4003,8 @@ static int sma6201_pwm_freq_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_AD_SPK_OCP_LVL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x70) >> 4);
 
 	return 0;
@@ -3299,8 +4021,8 @@ static int sma6201_pwm_freq_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 7))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL,
-			0x70, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_AD_SPK_OCP_LVL, 0x70, (sel << 4));
 
 	return 0;
 }
@@ -3320,7 +4042,8 @@ static int sma6201_ocp_filter_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_AD_SPK_OCP_LVL,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x0C) >> 2);
 
 	return 0;
@@ -3337,8 +4060,8 @@ static int sma6201_ocp_filter_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL,
-			0x0C, (sel << 2));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_AD_SPK_OCP_LVL, 0x0C, (sel << 2));
 
 	return 0;
 }
@@ -3357,7 +4080,8 @@ static int sma6201_ocp_lvl_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_AD_SPK_OCP_LVL,
+			&val);
 	ucontrol->value.integer.value[0] = (val & 0x03);
 
 	return 0;
@@ -3374,7 +4098,8 @@ static int sma6201_ocp_lvl_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL, 0x03, sel);
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_AD_SPK_OCP_LVL, 0x03, sel);
 
 	return 0;
 }
@@ -3395,7 +4120,8 @@ static int sma6201_sdo_data_select_get(struct snd_kcontrol *kcontrol,
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	int val;
 
-	regmap_read(sma6201->regmap, SMA6201_AE_TOP_MAN4, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, SMA6201_AE_TOP_MAN4,
+			&val);
 	ucontrol->value.integer.value[0] = ((val & 0x30) >> 4);
 
 	return 0;
@@ -3412,8 +4138,8 @@ static int sma6201_sdo_data_select_put(struct snd_kcontrol *kcontrol,
 	if ((sel < 0) || (sel > 3))
 		return -EINVAL;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_AE_TOP_MAN4,
-			0x30, (sel << 4));
+	sma6201_io_update_bits(sma6201, SMA6201_IO_KCONTROL,
+			SMA6201_AE_TOP_MAN4, 0x30, (sel << 4));
 
 	return 0;
 }
@@ -3463,12 +4189,162 @@ static int voice_music_class_h_mode_get(struct snd_kcontrol *kcontrol,
 	return 0;
 }
 
+/* Class-H scene register image - {register, mask, value} */
+struct sma6201_scene_reg {
+	unsigned int reg;
+	unsigned int mask;
+	unsigned int val;
+};
+
+/* Registers of the largest scene */
+#define SMA6201_SCENE_MAX_REGS	27
+
+#define SCENE_WRITE(_reg, _val) { .reg = _reg, .mask = 0xFF, .val = _val }
+#define SCENE_UPDATE(_reg, _mask, _val) \
+	{ .reg = _reg, .mask = _mask, .val = _val }
+
+/* FDPEC gain 3 & Boost 8V in voice scenario */
+static const struct sma6201_scene_reg sma6201_voice_scene_rev0[] = {
+	SCENE_WRITE(SMA6201_0D_CLASS_H_CTRL_LVL1, 0xFC),
+	SCENE_WRITE(SMA6201_0F_CLASS_H_CTRL_LVL2, 0xFB),
+	SCENE_UPDATE(SMA6201_93_BOOST_CTRL0, TRM_VBST1_MASK, TRM_VBST1_8V),
+	SCENE_UPDATE(SMA6201_95_BOOST_CTRL2, TRM_OCL_MASK, TRM_OCL_1P6_A),
+	SCENE_WRITE(SMA6201_97_BOOST_CTRL4, 0xA4),
+	SCENE_WRITE(SMA6201_A9_TONE_FINE_VOL, 0xA7),
+	SCENE_UPDATE(SMA6201_13_FDPEC_CTRL1, FDPEC_GAIN_MASK, FDPEC_GAIN_3),
+	SCENE_WRITE(SMA6201_91_CLASS_H_CTRL_LVL7, 0xB6),
+	SCENE_UPDATE(SMA6201_92_FDPEC_CTRL2, EN_DGC_MASK, DGC_DISABLE),
+};
+
+/* FDPEC gain 2 & Boost 8V in voice scenario */
+static const struct sma6201_scene_reg sma6201_voice_scene[] = {
+	/* HPF Frequency - 82 Hz */
+	SCENE_WRITE(SMA6201_15_BASS_SPK1, 0x02),
+	SCENE_WRITE(SMA6201_16_BASS_SPK2, 0x08),
+	SCENE_WRITE(SMA6201_17_BASS_SPK3, 0x08),
+	SCENE_WRITE(SMA6201_18_BASS_SPK4, 0x11),
+	SCENE_WRITE(SMA6201_19_BASS_SPK5, 0x6E),
+	SCENE_WRITE(SMA6201_1A_BASS_SPK6, 0x33),
+	SCENE_WRITE(SMA6201_1B_BASS_SPK7, 0x0A),
+
+	SCENE_WRITE(SMA6201_0D_CLASS_H_CTRL_LVL1, 0xF7),
+	SCENE_WRITE(SMA6201_0F_CLASS_H_CTRL_LVL2, 0xF6),
+	SCENE_WRITE(SMA6201_28_CLASS_H_CTRL_LVL3, 0x15),
+	SCENE_WRITE(SMA6201_29_CLASS_H_CTRL_LVL4, 0x24),
+	SCENE_WRITE(SMA6201_2A_CLASS_H_CTRL_LVL5, 0x23),
+	SCENE_WRITE(SMA6201_90_CLASS_H_CTRL_LVL6, 0x52),
+	SCENE_WRITE(SMA6201_91_CLASS_H_CTRL_LVL7, 0xB1),
+	SCENE_WRITE(SMA6201_38_DIS_CLASSH_LVL12, 0xCC),
+
+	SCENE_WRITE(SMA6201_95_BOOST_CTRL2, 0x0E),
+	SCENE_WRITE(SMA6201_97_BOOST_CTRL4, 0xE9),
+	SCENE_WRITE(SMA6201_A9_TONE_FINE_VOL, 0x87),
+	SCENE_WRITE(SMA6201_0A_SPK_VOL, 0x30),
+
+	SCENE_WRITE(SMA6201_23_COMP_LIM1, 0x1F),
+	SCENE_WRITE(SMA6201_24_COMP_LIM2, 0x02),
+	SCENE_WRITE(SMA6201_25_COMP_LIM3, 0x09),
+	SCENE_WRITE(SMA6201_26_COMP_LIM4, 0xFF),
+
+	SCENE_UPDATE(SMA6201_13_FDPEC_CTRL1, FDPEC_GAIN_MASK, FDPEC_GAIN_2),
+	SCENE_UPDATE(SMA6201_93_BOOST_CTRL0, TRM_VBST1_MASK, TRM_VBST1_8V),
+	SCENE_UPDATE(SMA6201_95_BOOST_CTRL2, TRM_OCL_MASK, TRM_OCL_1P2_A),
+	SCENE_UPDATE(SMA6201_92_FDPEC_CTRL2, EN_DGC_MASK, DGC_DISABLE),
+};
+
+/* FDPEC gain 8 & Boost 18V in music scenario */
+static const struct sma6201_scene_reg sma6201_music_scene_rev0[] = {
+	SCENE_WRITE(SMA6201_0D_CLASS_H_CTRL_LVL1, 0x4C),
+	SCENE_WRITE(SMA6201_0F_CLASS_H_CTRL_LVL2, 0x3B),
+	SCENE_WRITE(SMA6201_91_CLASS_H_CTRL_LVL7, 0xD6),
+	SCENE_WRITE(SMA6201_97_BOOST_CTRL4, 0xE4),
+	SCENE_WRITE(SMA6201_A9_TONE_FINE_VOL, 0x87),
+	SCENE_UPDATE(SMA6201_93_BOOST_CTRL0, TRM_VBST1_MASK, TRM_VBST1_18V),
+	SCENE_UPDATE(SMA6201_92_FDPEC_CTRL2, EN_DGC_MASK, DGC_ENABLE),
+	SCENE_UPDATE(SMA6201_13_FDPEC_CTRL1, FDPEC_GAIN_MASK, FDPEC_GAIN_8),
+	SCENE_UPDATE(SMA6201_95_BOOST_CTRL2, TRM_OCL_MASK, TRM_OCL_3P1_A),
+};
+
+/* FDPEC gain 8 & Boost 18V in music scenario */
+static const struct sma6201_scene_reg sma6201_music_scene[] = {
+	/* HPF Frequency - 97 Hz */
+	SCENE_WRITE(SMA6201_15_BASS_SPK1, 0x03),
+	SCENE_WRITE(SMA6201_16_BASS_SPK2, 0x05),
+	SCENE_WRITE(SMA6201_17_BASS_SPK3, 0x05),
+	SCENE_WRITE(SMA6201_18_BASS_SPK4, 0x0E),
+	SCENE_WRITE(SMA6201_19_BASS_SPK5, 0x21),
+	SCENE_WRITE(SMA6201_1A_BASS_SPK6, 0x0B),
+	SCENE_WRITE(SMA6201_1B_BASS_SPK7, 0x06),
+
+	SCENE_WRITE(SMA6201_0D_CLASS_H_CTRL_LVL1, 0x9C),
+	SCENE_WRITE(SMA6201_0F_CLASS_H_CTRL_LVL2, 0x6B),
+	SCENE_WRITE(SMA6201_28_CLASS_H_CTRL_LVL3, 0x7A),
+	SCENE_WRITE(SMA6201_29_CLASS_H_CTRL_LVL4, 0xA9),
+	SCENE_WRITE(SMA6201_2A_CLASS_H_CTRL_LVL5, 0x68),
+	SCENE_WRITE(SMA6201_90_CLASS_H_CTRL_LVL6, 0x97),
+	SCENE_WRITE(SMA6201_91_CLASS_H_CTRL_LVL7, 0xC6),
+	SCENE_WRITE(SMA6201_38_DIS_CLASSH_LVL12, 0xC8),
+
+	SCENE_WRITE(SMA6201_95_BOOST_CTRL2, 0x4E),
+	SCENE_WRITE(SMA6201_97_BOOST_CTRL4, 0x41),
+	SCENE_WRITE(SMA6201_A9_TONE_FINE_VOL, 0x77),
+	SCENE_WRITE(SMA6201_0A_SPK_VOL, 0x32),
+
+	SCENE_WRITE(SMA6201_23_COMP_LIM1, 0x1E),
+	SCENE_WRITE(SMA6201_24_COMP_LIM2, 0x2E),
+	SCENE_WRITE(SMA6201_25_COMP_LIM3, 0x09),
+	SCENE_WRITE(SMA6201_26_COMP_LIM4, 0xFF),
+
+	SCENE_UPDATE(SMA6201_93_BOOST_CTRL0, TRM_VBST1_MASK, TRM_VBST1_18V),
+	SCENE_UPDATE(SMA6201_92_FDPEC_CTRL2, EN_DGC_MASK, DGC_DISABLE),
+	SCENE_UPDATE(SMA6201_13_FDPEC_CTRL1, FDPEC_GAIN_MASK, FDPEC_GAIN_8),
+	SCENE_UPDATE(SMA6201_95_BOOST_CTRL2, TRM_OCL_MASK, TRM_OCL_3P1_A),
+};
+
+/* Apply only the registers of the scene image that differ from
+ * the register cache
+ */
+static int sma6201_apply_scene(struct sma6201_priv *sma6201,
+		const struct sma6201_scene_reg *scene, int num)
+{
+	struct sma6201_txn_reg regs[SMA6201_SCENE_MAX_REGS];
+	struct sma6201_txn txn;
+	ktime_t start = ktime_get();
+	s64 latency;
+	int i, writes;
+
+	BUILD_BUG_ON(ARRAY_SIZE(sma6201_voice_scene) > SMA6201_SCENE_MAX_REGS);
+	BUILD_BUG_ON(ARRAY_SIZE(sma6201_music_scene) > SMA6201_SCENE_MAX_REGS);
+
+	sma6201_txn_begin(sma6201, &txn, SMA6201_IO_KCONTROL, "class_h_mode",
+			regs, ARRAY_SIZE(regs));
+	for (i = 0; i < num; i++)
+		sma6201_txn_update(&txn, scene[i].reg,
+				scene[i].mask, scene[i].val);
+	writes = sma6201_txn_commit(&txn);
+	sma6201_shadow_invalidate(sma6201);
+	if (writes < 0)
+		return writes;
+
+	latency = ktime_us_delta(ktime_get(), start);
+
+	sma6201->scene_stats.switches++;
+	sma6201->scene_stats.last_writes = writes;
+	sma6201->scene_stats.total_writes += writes;
+	sma6201->scene_stats.last_latency_us = latency;
+	if (latency > sma6201->scene_stats.max_latency_us)
+		sma6201->scene_stats.max_latency_us = latency;
+
+	return 0;
+}
+
 static int voice_music_class_h_mode_put(struct snd_kcontrol *kcontrol,
 				struct snd_ctl_elem_value *ucontrol)
 {
 	struct snd_soc_component *component =
 		snd_soc_kcontrol_component(kcontrol);
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	bool rev0 = (sma6201->rev_num == REV_NUM_REV0);
 
 	sma6201->voice_music_class_h_mode = ucontrol->value.integer.value[0];
 
@@ -3478,284 +4354,26 @@ static int voice_music_class_h_mode_put(struct snd_kcontrol *kcontrol,
 
 	switch (sma6201->voice_music_class_h_mode) {
 	case SMA6201_CLASS_H_VOICE_MODE:
-	/* FDPEC gain & Boost voltage in
-	 * voice scenario
-	 */
-	if (sma6201->rev_num == REV_NUM_REV0) {
-		dev_info(component->dev, "%s : FDPEC gain 3 & Boost 8V in voice scenario\n",
-				__func__);
-		regmap_write(sma6201->regmap,
-			SMA6201_0D_CLASS_H_CTRL_LVL1, 0xFC);
-		regmap_write(sma6201->regmap,
-			SMA6201_0F_CLASS_H_CTRL_LVL2, 0xFB);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_93_BOOST_CTRL0,
-				TRM_VBST1_MASK, TRM_VBST1_8V);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_95_BOOST_CTRL2,
-				TRM_OCL_MASK, TRM_OCL_1P6_A);
-		regmap_write(sma6201->regmap,
-			SMA6201_97_BOOST_CTRL4, 0xA4);
-		regmap_write(sma6201->regmap,
-			SMA6201_A9_TONE_FINE_VOL, 0xA7);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_13_FDPEC_CTRL1,
-				FDPEC_GAIN_MASK, FDPEC_GAIN_3);
-		regmap_write(sma6201->regmap,
-			SMA6201_91_CLASS_H_CTRL_LVL7, 0xB6);
-	} else {
-		dev_info(component->dev, "%s : FDPEC gain 2 & Boost 8V in voice scenario\n",
-				__func__);
-		/* HPF Frequency - 82 Hz */
-		regmap_write(sma6201->regmap,
-			SMA6201_15_BASS_SPK1, 0x02);
-		regmap_write(sma6201->regmap,
-			SMA6201_16_BASS_SPK2, 0x08);
-		regmap_write(sma6201->regmap,
-			SMA6201_17_BASS_SPK3, 0x08);
-		regmap_write(sma6201->regmap,
-			SMA6201_18_BASS_SPK4, 0x11);
-		regmap_write(sma6201->regmap,
-			SMA6201_19_BASS_SPK5, 0x6E);
-		regmap_write(sma6201->regmap,
-			SMA6201_1A_BASS_SPK6, 0x33);
-		regmap_write(sma6201->regmap,
-			SMA6201_1B_BASS_SPK7, 0x0A);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_0D_CLASS_H_CTRL_LVL1, 0xF7);
-		regmap_write(sma6201->regmap,
-			SMA6201_0F_CLASS_H_CTRL_LVL2, 0xF6);
-		regmap_write(sma6201->regmap,
-			SMA6201_28_CLASS_H_CTRL_LVL3, 0x15);
-		regmap_write(sma6201->regmap,
-			SMA6201_29_CLASS_H_CTRL_LVL4, 0x24);
-		regmap_write(sma6201->regmap,
-			SMA6201_2A_CLASS_H_CTRL_LVL5, 0x23);
-		regmap_write(sma6201->regmap,
-			SMA6201_90_CLASS_H_CTRL_LVL6, 0x52);
-		regmap_write(sma6201->regmap,
-			SMA6201_91_CLASS_H_CTRL_LVL7, 0xB1);
-		regmap_write(sma6201->regmap,
-			SMA6201_38_DIS_CLASSH_LVL12, 0xCC);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_95_BOOST_CTRL2, 0x0E);
-		regmap_write(sma6201->regmap,
-			SMA6201_97_BOOST_CTRL4, 0xE9);
-		regmap_write(sma6201->regmap,
-			SMA6201_A9_TONE_FINE_VOL, 0x87);
-		regmap_write(sma6201->regmap,
-			SMA6201_0A_SPK_VOL, 0x30);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_23_COMP_LIM1, 0x1F);
-		regmap_write(sma6201->regmap,
-			SMA6201_24_COMP_LIM2, 0x02);
-		regmap_write(sma6201->regmap,
-			SMA6201_25_COMP_LIM3, 0x09);
-		regmap_write(sma6201->regmap,
-			SMA6201_26_COMP_LIM4, 0xFF);
-
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_13_FDPEC_CTRL1,
-				FDPEC_GAIN_MASK, FDPEC_GAIN_2);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_93_BOOST_CTRL0,
-				TRM_VBST1_MASK, TRM_VBST1_8V);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_95_BOOST_CTRL2,
-				TRM_OCL_MASK, TRM_OCL_1P2_A);
-	}
-	regmap_update_bits(sma6201->regmap,
-		SMA6201_92_FDPEC_CTRL2,
-			EN_DGC_MASK, DGC_DISABLE);
-	break;
+		dev_info(component->dev, "%s : FDPEC gain %d & Boost 8V in voice scenario\n",
+				__func__, rev0 ? 3 : 2);
+		if (rev0)
+			return sma6201_apply_scene(sma6201,
+				sma6201_voice_scene_rev0,
+				ARRAY_SIZE(sma6201_voice_scene_rev0));
+		return sma6201_apply_scene(sma6201, sma6201_voice_scene,
+				ARRAY_SIZE(sma6201_voice_scene));
 
 	case SMA6201_CLASS_H_MUSIC_MODE:
-	/* FDPEC gain & Boost voltage in
-	 * music scenario
-	 */
-	dev_info(component->dev, "%s : FDPEC gain 8 & Boost 18V in music scenario\n",
-			__func__);
-	if (sma6201->rev_num == REV_NUM_REV0) {
-		regmap_write(sma6201->regmap,
-			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x4C);
-		regmap_write(sma6201->regmap,
-			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x3B);
-		regmap_write(sma6201->regmap,
-			SMA6201_91_CLASS_H_CTRL_LVL7, 0xD6);
-		regmap_write(sma6201->regmap,
-			SMA6201_97_BOOST_CTRL4, 0xE4);
-		regmap_write(sma6201->regmap,
-			SMA6201_A9_TONE_FINE_VOL, 0x87);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_93_BOOST_CTRL0,
-				TRM_VBST1_MASK, TRM_VBST1_18V);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_92_FDPEC_CTRL2,
-				EN_DGC_MASK, DGC_ENABLE);
-	} else {
-		/* HPF Frequency - 97 Hz */
-		regmap_write(sma6201->regmap,
-			SMA6201_15_BASS_SPK1, 0x03);
-		regmap_write(sma6201->regmap,
-			SMA6201_16_BASS_SPK2, 0x05);
-		regmap_write(sma6201->regmap,
-			SMA6201_17_BASS_SPK3, 0x05);
-		regmap_write(sma6201->regmap,
-			SMA6201_18_BASS_SPK4, 0x0E);
-		regmap_write(sma6201->regmap,
-			SMA6201_19_BASS_SPK5, 0x21);
-		regmap_write(sma6201->regmap,
-			SMA6201_1A_BASS_SPK6, 0x0B);
-		regmap_write(sma6201->regmap,
-			SMA6201_1B_BASS_SPK7, 0x06);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x9C);
-		regmap_write(sma6201->regmap,
-			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x6B);
-		regmap_write(sma6201->regmap,
-			SMA6201_28_CLASS_H_CTRL_LVL3, 0x7A);
-		regmap_write(sma6201->regmap,
-			SMA6201_29_CLASS_H_CTRL_LVL4, 0xA9);
-		regmap_write(sma6201->regmap,
-			SMA6201_2A_CLASS_H_CTRL_LVL5, 0x68);
-		regmap_write(sma6201->regmap,
-			SMA6201_90_CLASS_H_CTRL_LVL6, 0x97);
-		regmap_write(sma6201->regmap,
-			SMA6201_91_CLASS_H_CTRL_LVL7, 0xC6);
-		regmap_write(sma6201->regmap,
-			SMA6201_38_DIS_CLASSH_LVL12, 0xC8);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_95_BOOST_CTRL2, 0x4E);
-		regmap_write(sma6201->regmap,
-			SMA6201_97_BOOST_CTRL4, 0x41);
-		regmap_write(sma6201->regmap,
-			SMA6201_A9_TONE_FINE_VOL, 0x77);
-		regmap_write(sma6201->regmap,
-			SMA6201_0A_SPK_VOL, 0x32);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_23_COMP_LIM1, 0x1E);
-		regmap_write(sma6201->regmap,
-			SMA6201_24_COMP_LIM2, 0x2E);
-		regmap_write(sma6201->regmap,
-			SMA6201_25_COMP_LIM3, 0x09);
-		regmap_write(sma6201->regmap,
-			SMA6201_26_COMP_LIM4, 0xFF);
-
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_93_BOOST_CTRL0,
-				TRM_VBST1_MASK, TRM_VBST1_18V);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_92_FDPEC_CTRL2,
-				EN_DGC_MASK, DGC_DISABLE);
-	}
-	regmap_update_bits(sma6201->regmap,
-		SMA6201_13_FDPEC_CTRL1,
-			FDPEC_GAIN_MASK, FDPEC_GAIN_8);
-
-	regmap_update_bits(sma6201->regmap,
-		SMA6201_95_BOOST_CTRL2,
-			TRM_OCL_MASK, TRM_OCL_3P1_A);
-
-	break;
-
 	default:
-	/* FDPEC gain & Boost voltage in
-	 * music scenario
-	 */
-	dev_info(component->dev, "%s : FDPEC gain 8 & Boost 18V in music scenario\n",
-			__func__);
-	if (sma6201->rev_num == REV_NUM_REV0) {
-		regmap_write(sma6201->regmap,
-			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x4C);
-		regmap_write(sma6201->regmap,
-			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x3B);
-		regmap_write(sma6201->regmap,
-			SMA6201_91_CLASS_H_CTRL_LVL7, 0xD6);
-		regmap_write(sma6201->regmap,
-			SMA6201_97_BOOST_CTRL4, 0xE4);
-		regmap_write(sma6201->regmap,
-			SMA6201_A9_TONE_FINE_VOL, 0x87);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_93_BOOST_CTRL0,
-				TRM_VBST1_MASK, TRM_VBST1_18V);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_92_FDPEC_CTRL2,
-				EN_DGC_MASK, DGC_ENABLE);
-	} else {
-		/* HPF Frequency - 97 Hz */
-		regmap_write(sma6201->regmap,
-			SMA6201_15_BASS_SPK1, 0x03);
-		regmap_write(sma6201->regmap,
-			SMA6201_16_BASS_SPK2, 0x05);
-		regmap_write(sma6201->regmap,
-			SMA6201_17_BASS_SPK3, 0x05);
-		regmap_write(sma6201->regmap,
-			SMA6201_18_BASS_SPK4, 0x0E);
-		regmap_write(sma6201->regmap,
-			SMA6201_19_BASS_SPK5, 0x21);
-		regmap_write(sma6201->regmap,
-			SMA6201_1A_BASS_SPK6, 0x0B);
-		regmap_write(sma6201->regmap,
-			SMA6201_1B_BASS_SPK7, 0x06);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x9C);
-		regmap_write(sma6201->regmap,
-			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x6B);
-		regmap_write(sma6201->regmap,
-			SMA6201_28_CLASS_H_CTRL_LVL3, 0x7A);
-		regmap_write(sma6201->regmap,
-			SMA6201_29_CLASS_H_CTRL_LVL4, 0xA9);
-		regmap_write(sma6201->regmap,
-			SMA6201_2A_CLASS_H_CTRL_LVL5, 0x68);
-		regmap_write(sma6201->regmap,
-			SMA6201_90_CLASS_H_CTRL_LVL6, 0x97);
-		regmap_write(sma6201->regmap,
-			SMA6201_91_CLASS_H_CTRL_LVL7, 0xC6);
-		regmap_write(sma6201->regmap,
-			SMA6201_38_DIS_CLASSH_LVL12, 0xC8);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_95_BOOST_CTRL2, 0x4E);
-		regmap_write(sma6201->regmap,
-			SMA6201_97_BOOST_CTRL4, 0x41);
-		regmap_write(sma6201->regmap,
-			SMA6201_A9_TONE_FINE_VOL, 0x77);
-		regmap_write(sma6201->regmap,
-			SMA6201_0A_SPK_VOL, 0x32);
-
-		regmap_write(sma6201->regmap,
-			SMA6201_23_COMP_LIM1, 0x1E);
-		regmap_write(sma6201->regmap,
-			SMA6201_24_COMP_LIM2, 0x2E);
-		regmap_write(sma6201->regmap,
-			SMA6201_25_COMP_LIM3, 0x09);
-		regmap_write(sma6201->regmap,
-			SMA6201_26_COMP_LIM4, 0xFF);
-
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_93_BOOST_CTRL0,
-				TRM_VBST1_MASK, TRM_VBST1_18V);
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_92_FDPEC_CTRL2,
-				EN_DGC_MASK, DGC_DISABLE);
-	}
-	regmap_update_bits(sma6201->regmap,
-		SMA6201_13_FDPEC_CTRL1,
-			FDPEC_GAIN_MASK, FDPEC_GAIN_8);
-
-	regmap_update_bits(sma6201->regmap,
-		SMA6201_95_BOOST_CTRL2,
-			TRM_OCL_MASK, TRM_OCL_3P1_A);
+		dev_info(component->dev, "%s : FDPEC gain 8 & Boost 18V in music scenario\n",
+				__func__);
+		if (rev0)
+			return sma6201_apply_scene(sma6201,
+				sma6201_music_scene_rev0,
+				ARRAY_SIZE(sma6201_music_scene_rev0));
+		return sma6201_apply_scene(sma6201, sma6201_music_scene,
+				ARRAY_SIZE(sma6201_music_scene));
 	}
-
-	return 0;
 }
 
 static int sma6201_put_volsw(struct snd_kcontrol *kcontrol,
@@ -3777,7 +4395,7 @@ static int sma6201_put_volsw(struct snd_kcontrol *kcontrol,
 		mutex_unlock(&sma6201->lock);
 		return ret;
 	}
-	regmap_read(sma6201->regmap, reg, &val);
+	sma6201_io_read(sma6201, SMA6201_IO_KCONTROL, reg, &val);
 
 	if (val != sma6201->init_vol) {
 		dev_dbg(component->dev, "%s :  init vol[%d] updated to vol[%d]\n",
@@ -3841,8 +4459,9 @@ SOC_ENUM_EXT("Volume slope", sma6201_vol_slope_enum,
 	sma6201_vol_slope_get, sma6201_vol_slope_put),
 SOC_ENUM_EXT("DAC Mute slope", sma6201_mute_slope_enum,
 	sma6201_mute_slope_get, sma6201_mute_slope_put),
-SOC_SINGLE("SPK Mute Switch(1:mute_0:un)",
-		SMA6201_0E_MUTE_VOL_CTRL, 0, 1, 0),
+SOC_SINGLE_EXT("SPK Mute Switch(1:mute_0:un)",
+		SMA6201_0E_MUTE_VOL_CTRL, 0, 1, 0,
+		snd_soc_get_volsw, sma6201_shadow_put_volsw),
 
 SOC_ENUM_EXT("Attack level control2", sma6201_attack_lvl_2_enum,
 	sma6201_attack_lvl_2_get, sma6201_attack_lvl_2_put),
@@ -4074,7 +4693,6 @@ SOC_SINGLE("SDO Pad Out ctrl2(1:O_0:N)",
 SOC_SINGLE("Monitor SDO(1:OSC_0:PLL)", SMA6201_A3_TOP_MAN2, 7, 1, 0),
 SOC_SINGLE("Test clk(1:clk out_0:nml)",
 		SMA6201_A3_TOP_MAN2, 6, 1, 0),
-SOC_SINGLE("PLL SDM PD(1:off_0:on)", SMA6201_A3_TOP_MAN2, 5, 1, 0),
 SOC_SINGLE("IRQ clear(1:clear_0:nml)",
 		SMA6201_A3_TOP_MAN2, 4, 1, 0),
 SOC_SINGLE("SDO output(1:high-Z_0:nml)",
@@ -4134,8 +4752,9 @@ SOC_SINGLE("Tone audio mix(1:on_0:off)",
 		SMA6201_A8_TONE_GENERATOR, 5, 1, 0),
 SOC_ENUM_EXT("Tone frequency", sma6201_tone_freq_enum,
 	sma6201_tone_freq_get, sma6201_tone_freq_put),
-SOC_SINGLE("Tone switch(1:on_0:off)",
-		SMA6201_A8_TONE_GENERATOR, 0, 1, 0),
+SOC_SINGLE_EXT("Tone switch(1:on_0:off)",
+		SMA6201_A8_TONE_GENERATOR, 0, 1, 0,
+		snd_soc_get_volsw, sma6201_shadow_put_volsw),
 
 SND_SOC_BYTES_EXT("Tone/Fine Volume", 1,
 	tone_fine_volume_get, tone_fine_volume_put),
@@ -4156,7 +4775,8 @@ SOC_ENUM_EXT("SPK OCP Level", sma6201_ocp_lvl_enum,
 
 SOC_SINGLE("SDO Order(1:R_0:N)",
 		SMA6201_AE_TOP_MAN4, 7, 1, 0),
-SOC_SINGLE("IRQ(1:high-Z_0:nml)", SMA6201_AE_TOP_MAN4, 6, 1, 0),
+SOC_SINGLE_EXT("IRQ(1:high-Z_0:nml)", SMA6201_AE_TOP_MAN4, 6, 1, 0,
+		snd_soc_get_volsw, sma6201_shadow_put_volsw),
 SOC_ENUM_EXT("SDO Data Selection", sma6201_sdo_data_select_enum,
 	sma6201_sdo_data_select_get, sma6201_sdo_data_select_put),
 SOC_SINGLE("SDO Data ADC(1:index_0:no)",
@@ -4180,80 +4800,345 @@ SOC_ENUM_EXT("Class H mode(Voice_Music_None)",
 	voice_music_class_h_mode_get, voice_music_class_h_mode_put),
 };
 
-static int sma6201_startup(struct snd_soc_component *component)
+static bool sma6201_cacheable_register(struct device *dev, unsigned int reg)
 {
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	return sma6201_writeable_register(dev, reg) &&
+		!sma6201_volatile_register(dev, reg);
+}
+
+/* Deferred mode while the amp is powered down
+ * Register writes only land in the register cache until startup.
+ *
+ * The chip keeps its registers while POWER is off, so the cache and
+ * the chip only differ by the writes made in cache only mode. regmap
+ * does not record which registers those were: regcache_mark_dirty()
+ * with regcache_sync() would rewrite every register that differs from
+ * its default, i.e. the whole init image and both EQ banks, on each
+ * power up. The snapshot diff keeps the flush to the changed registers.
+ * Both passes read the cache only, no I2C access.
+ */
+static void sma6201_defer_writes(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site)
+{
+	unsigned int reg, val;
+
+	if (sma6201->cache_deferred)
+		return;
+
+	/* Snapshot of the register values applied to the chip */
+	for (reg = 0; reg <= SMA6201_EQ_BANK_MAX; reg++) {
+		if (!sma6201_cacheable_register(sma6201->dev, reg))
+			continue;
+		if (sma6201_io_read(sma6201, site, reg, &val) == 0)
+			sma6201->cache_snapshot[reg] = val;
+	}
+
+	regcache_cache_only(sma6201->regmap, true);
+	sma6201->cache_deferred = true;
+
+	dev_dbg(sma6201->dev, "%s : cache only\n", __func__);
+}
+
+/* Leave deferred mode and write every register changed in the cache
+ * since the snapshot, merging adjacent registers into bursts
+ */
+static int sma6201_flush_deferred_writes(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site)
+{
+	unsigned int reg, val, start = 0, len = 0;
+	int ret = 0, writes = 0;
+
+	if (!sma6201->cache_deferred)
+		return 0;
+
+	regcache_cache_only(sma6201->regmap, false);
+	sma6201->cache_deferred = false;
+
+	for (reg = 0; reg <= SMA6201_EQ_BANK_MAX + 1; reg++) {
+		if (reg <= SMA6201_EQ_BANK_MAX &&
+			sma6201_cacheable_register(sma6201->dev, reg) &&
+			sma6201_io_read(sma6201, site, reg, &val) == 0 &&
+			val != sma6201->cache_snapshot[reg]) {
+			if (len == 0)
+				start = reg;
+			sma6201->cache_snapshot[reg] = val;
+			len++;
+			continue;
+		}
+
+		if (len == 0)
+			continue;
+
+		if (len == 1)
+			ret = sma6201_io_write(sma6201, site, start,
+					sma6201->cache_snapshot[start]);
+		else
+			ret = sma6201_io_raw_write(sma6201, site, start,
+					&sma6201->cache_snapshot[start], len);
+		if (ret) {
+			dev_err(sma6201->dev,
+				"%s : sync fail, register: %x ret: %d\n",
+					__func__, start, ret);
+			break;
+		}
+		writes++;
+		len = 0;
+	}
+
+	dev_dbg(sma6201->dev, "%s : %d writes\n", __func__, writes);
+
+	return ret;
+}
+
+/* True if the amp has not been powered down since the last startup,
+ * e.g. a restart within the autosuspend delay. Cache only, no I2C.
+ */
+static bool sma6201_amp_powered(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site)
+{
+	unsigned int val;
+
+	if (sma6201_io_read(sma6201, site, SMA6201_00_SYSTEM_CTRL, &val))
+		return false;
+
+	return (val & POWER_MASK) == POWER_ON;
+}
+
+/* Autosuspend delay of the idle power down */
+static void sma6201_update_autosuspend_delay(struct sma6201_priv *sma6201)
+{
+	int delay = MUTE_SLOPE_TIME;
+
+	if (sma6201->warm_standby_time > delay)
+		delay = sma6201->warm_standby_time;
+
+	if (sma6201->delayed_shutdown_enable &&
+		sma6201->delayed_time_shutdown * MSEC_PER_SEC > delay)
+		delay = sma6201->delayed_time_shutdown * MSEC_PER_SEC;
+
+	pm_runtime_set_autosuspend_delay(sma6201->dev, delay);
+}
+
+/* Sleep for what is left of the mute slope since the last mute */
+static void sma6201_wait_mute_slope(struct sma6201_priv *sma6201)
+{
+	s64 slope_us = MUTE_SLOPE_TIME * USEC_PER_MSEC -
+		ktime_us_delta(ktime_get(), sma6201->mute_time);
+
+	if (slope_us > 0)
+		usleep_range(slope_us, slope_us + 10);
+}
+
+/* Wait for the boost to settle after POWER_ON, the fixed delay
+ * first, and record the ready time
+ */
+static void sma6201_wait_startup_ready(struct sma6201_priv *sma6201)
+{
+	struct sma6201_ready_stats *stats = &sma6201->ready_stats;
+	ktime_t start = ktime_get();
+	unsigned int status = 0;
+	s64 ready_us;
+	int ret;
+
+	/* Improved boost OCP interrupt issue when turning on the amp */
+	msleep(STARTUP_READY_FLOOR_MS);
+
+	usleep_range(STARTUP_READY_MIN_US, STARTUP_READY_MIN_US + 10);
+
+	ret = sma6201_io_read_poll_timeout(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_FB_STATUS2, status,
+			!(status & STARTUP_READY_MASK), STARTUP_READY_POLL_US,
+			STARTUP_READY_TIMEOUT_US);
+	if (ret && ret != -ETIMEDOUT) {
+		dev_err(sma6201->dev, "%s : status read fail %d\n",
+				__func__, ret);
+		stats->errors++;
+		return;
+	}
+
+	ready_us = ktime_us_delta(ktime_get(), start);
+
+	if (ret == -ETIMEDOUT) {
+		dev_warn(sma6201->dev, "%s : not ready in %lldus, STATUS2 0x%02x\n",
+				__func__, ready_us, status);
+		stats->timeouts++;
+	}
+
+	if (!stats->count || ready_us < stats->min_us)
+		stats->min_us = ready_us;
+	if (ready_us > stats->max_us)
+		stats->max_us = ready_us;
+	stats->total_us += ready_us;
+	stats->hist[min_t(s64, div_s64(ready_us, 1000),
+			STARTUP_READY_HIST_BUCKETS - 1)]++;
+	stats->count++;
+}
+
+/* A stream start is accounted once both the unmute and the DAI
+ * trigger happened after the DAC power up, the first sound is
+ * the later of the two
+ */
+static void sma6201_start_account(struct sma6201_priv *sma6201, bool trigger)
+{
+	struct sma6201_start_stats *stats = &sma6201->start_stats;
+	ktime_t now = ktime_get(), sound;
+	unsigned long flags;
+
+	spin_lock_irqsave(&stats->lock, flags);
+
+	if (!ktime_to_ns(stats->pmu_time))
+		goto out;
+
+	if (trigger) {
+		if (ktime_to_ns(stats->trigger_time))
+			goto out;
+		stats->trigger_time = now;
+	} else {
+		if (ktime_to_ns(stats->unmute_time))
+			goto out;
+		stats->unmute_time = now;
+	}
+
+	if (!ktime_to_ns(stats->trigger_time) ||
+		!ktime_to_ns(stats->unmute_time))
+		goto out;
+
+	sound = ktime_after(stats->unmute_time, stats->trigger_time) ?
+		stats->unmute_time : stats->trigger_time;
+
+	stats->last_trigger_us = ktime_us_delta(sound, stats->trigger_time);
+	if (stats->last_trigger_us > stats->max_trigger_us)
+		stats->max_trigger_us = stats->last_trigger_us;
+	stats->total_trigger_us += stats->last_trigger_us;
+
+	stats->last_sound_us = ktime_us_delta(sound, stats->pmu_time);
+	if (stats->last_sound_us > stats->max_sound_us)
+		stats->max_sound_us = stats->last_sound_us;
+	stats->total_sound_us += stats->last_sound_us;
+
+	stats->count++;
+	stats->pmu_time = 0;
+out:
+	spin_unlock_irqrestore(&stats->lock, flags);
+}
+
+/* Unmute a powered amp unless the DAI asked for mute,
+ * see sma6201_dai_digital_mute
+ */
+static void sma6201_unmute(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site)
+{
+	mutex_lock(&sma6201->mute_lock);
+	if (!sma6201->dai_mute)
+		sma6201_shadow_update(sma6201, site, SMA6201_SHADOW_MUTE,
+				SPK_UNMUTE);
+	mutex_unlock(&sma6201->mute_lock);
+}
+
+static int sma6201_power_up(struct sma6201_priv *sma6201)
+{
+	bool powered;
+	ktime_t start;
+	int ret;
 
 	if (sma6201->amp_power_status) {
-		dev_info(component->dev, "%s : %s\n",
+		dev_dbg(sma6201->dev, "%s : %s\n",
 			__func__, "Already AMP Power on");
+		sma6201_start_account(sma6201, false);
 		return 0;
 	}
 
-	dev_info(component->dev, "%s\n", __func__);
+	dev_dbg(sma6201->dev, "%s\n", __func__);
 
-	if (sma6201->delayed_shutdown_enable)
-		cancel_delayed_work_sync(&sma6201->delayed_shutdown_work);
+	start = ktime_get();
+
+	/* Resume applies the settings changed while the amp was
+	 * powered down, a pending autosuspend is just cancelled
+	 */
+	ret = pm_runtime_get_sync(sma6201->dev);
+	if (ret < 0) {
+		dev_err(sma6201->dev, "%s : resume fail %d\n",
+				__func__, ret);
+		pm_runtime_put_noidle(sma6201->dev);
+		return ret;
+	}
+
+	cancel_delayed_work_sync(&sma6201->standby_work);
+
+	powered = sma6201_amp_powered(sma6201, SMA6201_IO_STARTUP);
+	if (powered)
+		sma6201->pm_stats.warm_starts++;
 
 	/* Please add code when applying external clock */
 	if ((sma6201->sys_clk_id != SMA6201_PLL_CLKIN_BCLK) &&
 			!(sma6201->ext_clk_status)) {
-		dev_info(component->dev, "%s : %s\n",
+		dev_dbg(sma6201->dev, "%s : %s\n",
 			__func__, "Applying external clock");
 
 		sma6201->ext_clk_status = true;
 	}
 
 	/* PLL LDO bypass enable */
-	regmap_update_bits(sma6201->regmap, SMA6201_AC_PLL_CTRL,
-			PLL_LDO_BYP_MASK, PLL_LDO_BYP_ENABLE);
+	sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_SHADOW_PLL_LDO_BYP, PLL_LDO_BYP_ENABLE);
 
-	regmap_update_bits(sma6201->regmap, SMA6201_00_SYSTEM_CTRL,
-			POWER_MASK, POWER_ON);
+	sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP, SMA6201_SHADOW_POWER,
+			POWER_ON);
 
 	/* Workaround - Defense code to resolve issues that do not change
 	 * from low IRQ pin when AMP is powered off
 	 */
-	regmap_update_bits(sma6201->regmap, SMA6201_AE_TOP_MAN4,
-				DIS_IRQ_MASK, NORMAL_OPERATION_IRQ);
+	sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_SHADOW_DIS_IRQ, NORMAL_OPERATION_IRQ);
 
 	/* Improved boost OCP interrupt issue when turning on the amp */
-	msleep(20);
-
-	usleep_range(1000, 1010);
+	if (!powered)
+		sma6201_wait_startup_ready(sma6201);
 
 	/* Improved high frequency noise issue when voice call scenario */
 	if (sma6201->voice_music_class_h_mode ==
 			SMA6201_CLASS_H_VOICE_MODE) {
-		regmap_update_bits(sma6201->regmap, SMA6201_A8_TONE_GENERATOR,
-			TONE_FREQ_MASK, TONE_FREQ_50);
-		regmap_update_bits(sma6201->regmap, SMA6201_03_INPUT1_CTRL3,
-			ADD_TONE_VOL_MASK, ADD_TONE_VOL_DECREASE);
-		regmap_update_bits(sma6201->regmap, SMA6201_A9_TONE_FINE_VOL,
-			TONE_VOL_MASK, TONE_VOL_M_36);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_A8_TONE_GENERATOR, TONE_FREQ_MASK,
+			TONE_FREQ_50);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_03_INPUT1_CTRL3, ADD_TONE_VOL_MASK,
+			ADD_TONE_VOL_DECREASE);
+		sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_SHADOW_TONE_VOL, TONE_VOL_M_36);
 	}
 
 	if (sma6201->stereo_two_chip == true) {
 		/* SPK Mode (Stereo) */
-		regmap_update_bits(sma6201->regmap, SMA6201_10_SYSTEM_CTRL1,
-				SPK_MODE_MASK, SPK_STEREO);
+		sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP,
+				SMA6201_SHADOW_SPK_MODE, SPK_STEREO);
 	} else {
 		/* SPK Mode (Mono) */
-		regmap_update_bits(sma6201->regmap, SMA6201_10_SYSTEM_CTRL1,
-				SPK_MODE_MASK, SPK_MONO);
+		sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP,
+				SMA6201_SHADOW_SPK_MODE, SPK_MONO);
 	}
 
 	/* Improved high frequency noise issue when voice call scenario */
-	regmap_update_bits(sma6201->regmap, SMA6201_A8_TONE_GENERATOR,
-			TONE_ON_MASK, TONE_ON);
+	sma6201_shadow_update(sma6201, SMA6201_IO_STARTUP,
+			SMA6201_SHADOW_TONE_ON, TONE_ON);
 
 	if (sma6201->check_thermal_vbat_enable) {
 		if ((sma6201->voice_music_class_h_mode ==
 				SMA6201_CLASS_H_MUSIC_MODE)
 			&& sma6201->check_thermal_vbat_period > 0) {
-			queue_delayed_work(system_freezable_wq,
-				&sma6201->check_thermal_vbat_work,
-				msecs_to_jiffies(100));
+			if (sma6201_temp_events(sma6201))
+				queue_work(system_freezable_wq,
+					&sma6201->temp_work);
+			else
+				queue_delayed_work(system_freezable_wq,
+					&sma6201->check_thermal_vbat_work,
+					msecs_to_jiffies(100));
+#ifdef CONFIG_SMA6201_BATTERY_READING
+			/* First sample before the supply changes */
+			if (sma6201->vbat_status < 0)
+				queue_work(system_freezable_wq,
+					&sma6201->vbat_work);
+#endif
 		}
 	}
 
@@ -4270,33 +5155,125 @@ static int sma6201_startup(struct snd_soc_component *component)
 
 	sma6201->amp_power_status = true;
 
-	regmap_update_bits(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL,
-				SPK_MUTE_MASK, SPK_UNMUTE);
+	sma6201_unmute(sma6201, SMA6201_IO_STARTUP);
+	sma6201_start_account(sma6201, false);
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_STARTUP, start);
+
+	return 0;
+}
+
+/* Wait for a queued startup before touching the power state */
+static int sma6201_wait_startup_done(struct sma6201_priv *sma6201)
+{
+	if (!wait_for_completion_timeout(&sma6201->startup_done,
+			msecs_to_jiffies(STARTUP_DONE_TIMEOUT))) {
+		dev_err(sma6201->dev, "%s : startup timeout\n", __func__);
+		return -ETIMEDOUT;
+	}
 
 	return 0;
 }
 
-static void sma6201_delayed_shutdown_worker(struct work_struct *work)
+static int sma6201_startup(struct snd_soc_component *component)
+{
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	int ret;
+
+	ret = sma6201_wait_startup_done(sma6201);
+	if (ret)
+		return ret;
+
+	return sma6201_power_up(sma6201);
+}
+
+static void sma6201_startup_worker(struct work_struct *work)
 {
 	struct sma6201_priv *sma6201 =
-		container_of(work, struct sma6201_priv,
-				delayed_shutdown_work.work);
+		container_of(work, struct sma6201_priv, startup_work);
+
+	sma6201_power_up(sma6201);
+
+	complete_all(&sma6201->startup_done);
+}
+
+/* Power up off the DAPM sequence, the output stays muted until
+ * the boost is ready and sma6201_power_up unmutes it
+ */
+static void sma6201_queue_startup(struct sma6201_priv *sma6201)
+{
+	if (!completion_done(&sma6201->startup_done))
+		return;
+
+	reinit_completion(&sma6201->startup_done);
+	queue_work(system_highpri_wq, &sma6201->startup_work);
+}
+
+/* Warm standby : the output stage goes off after the mute slope,
+ * the PLL and the references keep running until autosuspend so
+ * that a restart skips the PLL lock and the boost ready wait
+ */
+static void sma6201_standby_worker(struct work_struct *work)
+{
+	struct sma6201_priv *sma6201 =
+		container_of(work, struct sma6201_priv, standby_work.work);
+	ktime_t start = ktime_get();
+
+	sma6201_wait_mute_slope(sma6201);
+
+	if (sma6201->amp_power_status)
+		return;
+
+	dev_dbg(sma6201->dev, "%s : %ldms\n", __func__,
+			sma6201->warm_standby_time);
+
+	sma6201_shadow_update(sma6201, SMA6201_IO_STANDBY,
+			SMA6201_SHADOW_SPK_MODE, SPK_OFF);
+	sma6201_shadow_update(sma6201, SMA6201_IO_STANDBY,
+			SMA6201_SHADOW_TONE_VOL, TONE_VOL_OFF);
+	sma6201_shadow_update(sma6201, SMA6201_IO_STANDBY,
+			SMA6201_SHADOW_TONE_ON, TONE_OFF);
+
+	sma6201->pm_stats.standbys++;
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_STANDBY, start);
+}
+
+/* Idle power down after the autosuspend delay, also the system
+ * suspend path through pm_runtime_force_suspend
+ */
+static int __maybe_unused sma6201_runtime_suspend(struct device *dev)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
 	unsigned int cur_vol;
+	ktime_t start = ktime_get();
 
 	if (sma6201->delayed_shutdown_enable)
-		dev_info(sma6201->dev, "%s : %ldsec\n",
+		dev_dbg(sma6201->dev, "%s : %ldsec\n",
 			__func__, sma6201->delayed_time_shutdown);
 
-	regmap_update_bits(sma6201->regmap, SMA6201_10_SYSTEM_CTRL1,
-			SPK_MODE_MASK, SPK_OFF);
+	/* Forced suspend may come without a prior shutdown */
+	if (sma6201_shadow_update(sma6201, SMA6201_IO_RUNTIME_PM,
+			SMA6201_SHADOW_MUTE, SPK_MUTE) > 0)
+		sma6201->mute_time = ktime_get();
+
+	/* Wait out the rest of the mute slope when suspended early */
+	sma6201_wait_mute_slope(sma6201);
+
+	cancel_delayed_work_sync(&sma6201->standby_work);
+	cancel_delayed_work_sync(&sma6201->check_thermal_vbat_work);
+	cancel_delayed_work_sync(&sma6201->check_thermal_fault_work);
+
+	sma6201_shadow_update(sma6201, SMA6201_IO_RUNTIME_PM,
+			SMA6201_SHADOW_SPK_MODE, SPK_OFF);
 
-	regmap_update_bits(sma6201->regmap, SMA6201_00_SYSTEM_CTRL,
-			POWER_MASK, POWER_OFF);
+	sma6201_shadow_update(sma6201, SMA6201_IO_RUNTIME_PM,
+			SMA6201_SHADOW_POWER, POWER_OFF);
 
-	regmap_update_bits(sma6201->regmap, SMA6201_A9_TONE_FINE_VOL,
-			TONE_VOL_MASK, TONE_VOL_OFF);
-	regmap_update_bits(sma6201->regmap, SMA6201_A8_TONE_GENERATOR,
-			TONE_ON_MASK, TONE_OFF);
+	sma6201_shadow_update(sma6201, SMA6201_IO_RUNTIME_PM,
+			SMA6201_SHADOW_TONE_VOL, TONE_VOL_OFF);
+	sma6201_shadow_update(sma6201, SMA6201_IO_RUNTIME_PM,
+			SMA6201_SHADOW_TONE_ON, TONE_OFF);
 
 	if (atomic_read(&sma6201->irq_enabled)) {
 		disable_irq((unsigned int)sma6201->irq);
@@ -4306,14 +5283,14 @@ static void sma6201_delayed_shutdown_worker(struct work_struct *work)
 	/* PLL LDO bypass disable */
 	if (sma6201->sys_clk_id == SMA6201_PLL_CLKIN_MCLK
 		|| sma6201->sys_clk_id == SMA6201_PLL_CLKIN_BCLK)
-		regmap_update_bits(sma6201->regmap,
-			SMA6201_AC_PLL_CTRL,
-				PLL_LDO_BYP_MASK, PLL_LDO_BYP_DISABLE);
+		sma6201_shadow_update(sma6201, SMA6201_IO_RUNTIME_PM,
+				SMA6201_SHADOW_PLL_LDO_BYP,
+				PLL_LDO_BYP_DISABLE);
 
 	/* Please add code when removing external clock */
 	if ((sma6201->sys_clk_id != SMA6201_PLL_CLKIN_BCLK) &&
 			sma6201->ext_clk_status) {
-		dev_info(sma6201->dev, "%s : %s\n",
+		dev_dbg(sma6201->dev, "%s : %s\n",
 			__func__, "Removing external clock");
 
 		sma6201->ext_clk_status = false;
@@ -4327,62 +5304,101 @@ static void sma6201_delayed_shutdown_worker(struct work_struct *work)
 			mutex_lock(&sma6201->lock);
 			sma6201->threshold_level = 0;
 
-			regmap_read(sma6201->regmap, SMA6201_0A_SPK_VOL,
-						&cur_vol);
+			sma6201_io_read(sma6201, SMA6201_IO_RUNTIME_PM,
+						SMA6201_0A_SPK_VOL, &cur_vol);
 
 			if (cur_vol > sma6201->init_vol)
 				dev_info(sma6201->dev, "%s : cur vol[%d]  new vol[%d]\n",
 				__func__, cur_vol, sma6201->init_vol);
-				regmap_write(sma6201->regmap,
+				sma6201_io_write(sma6201, SMA6201_IO_RUNTIME_PM,
 					SMA6201_0A_SPK_VOL, sma6201->init_vol);
 			mutex_unlock(&sma6201->lock);
 		}
 	}
+
+	sma6201_defer_writes(sma6201, SMA6201_IO_RUNTIME_PM);
+
+	sma6201->pm_stats.suspends++;
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_POWER_DOWN, start);
+
+	return 0;
 }
 
-static int sma6201_shutdown(struct snd_soc_component *component)
+/* Apply the settings changed while the amp was powered down */
+static int __maybe_unused sma6201_runtime_resume(struct device *dev)
 {
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	struct sma6201_pm_stats *stats = &sma6201->pm_stats;
+	ktime_t start = ktime_get();
+	int ret;
 
-	if (!(sma6201->amp_power_status)) {
-		dev_info(component->dev, "%s : %s\n",
-			__func__, "Already AMP Shutdown");
-		return 0;
-	}
+	ret = sma6201_flush_deferred_writes(sma6201, SMA6201_IO_RUNTIME_PM);
 
-	dev_info(component->dev, "%s\n", __func__);
+	stats->last_resume_us = ktime_us_delta(ktime_get(), start);
+	if (stats->last_resume_us > stats->max_resume_us)
+		stats->max_resume_us = stats->last_resume_us;
+	stats->total_resume_us += stats->last_resume_us;
+	stats->resumes++;
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_RESUME, start);
+
+	return ret;
+}
+
+static int sma6201_power_down(struct sma6201_priv *sma6201)
+{
+	ktime_t start;
+
+	if (!(sma6201->amp_power_status)) {
+		dev_dbg(sma6201->dev, "%s : %s\n",
+			__func__, "Already AMP Shutdown");
+		return 0;
+	}
+
+	dev_dbg(sma6201->dev, "%s\n", __func__);
+
+	start = ktime_get();
 
 	/* Workaround - Defense code to resolve issues that do not change
 	 * from low IRQ pin when AMP is powered off
 	 */
-	regmap_update_bits(sma6201->regmap, SMA6201_AE_TOP_MAN4,
-				DIS_IRQ_MASK, HIGH_Z_IRQ);
+	sma6201_shadow_update(sma6201, SMA6201_IO_SHUTDOWN,
+			SMA6201_SHADOW_DIS_IRQ, HIGH_Z_IRQ);
 
-	regmap_update_bits(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL,
-				SPK_MUTE_MASK, SPK_MUTE);
+	if (sma6201_shadow_update(sma6201, SMA6201_IO_SHUTDOWN,
+			SMA6201_SHADOW_MUTE, SPK_MUTE) > 0)
+		sma6201->mute_time = ktime_get();
 
-	cancel_delayed_work_sync(&sma6201->check_thermal_vbat_work);
-	cancel_delayed_work_sync(&sma6201->check_thermal_fault_work);
+	sma6201->amp_power_status = false;
 
-	/* Mute slope time(15ms) */
-	usleep_range(15000, 15010);
+	/* Power down after the autosuspend delay(at least the mute
+	 * slope time) in sma6201_runtime_suspend
+	 */
+	pm_runtime_mark_last_busy(sma6201->dev);
+	pm_runtime_put_autosuspend(sma6201->dev);
 
-	if (sma6201->delayed_shutdown_enable) {
-		__pm_wakeup_event(&sma6201->shutdown_wakesrc,
-			sma6201->delayed_time_shutdown * HZ);
-		queue_delayed_work(system_freezable_wq,
-			&sma6201->delayed_shutdown_work,
-			sma6201->delayed_time_shutdown * HZ);
-	} else {
-		queue_delayed_work(system_freezable_wq,
-			&sma6201->delayed_shutdown_work, 0);
-	}
+	if (sma6201->warm_standby_time > 0)
+		queue_delayed_work(system_freezable_wq, &sma6201->standby_work,
+			msecs_to_jiffies(MUTE_SLOPE_TIME));
 
-	sma6201->amp_power_status = false;
+	sma6201_phase_end(sma6201, SMA6201_PHASE_SHUTDOWN, start);
 
 	return 0;
 }
 
+static int sma6201_shutdown(struct snd_soc_component *component)
+{
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	int ret;
+
+	ret = sma6201_wait_startup_done(sma6201);
+	if (ret)
+		return ret;
+
+	return sma6201_power_down(sma6201);
+}
+
 static int sma6201_clk_supply_event(struct snd_soc_dapm_widget *w,
 			struct snd_kcontrol *kcontrol, int event)
 {
@@ -4408,29 +5424,54 @@ static int sma6201_dac_event(struct snd_soc_dapm_widget *w,
 	struct snd_soc_component *component =
 		snd_soc_dapm_to_component(w->dapm);
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	struct sma6201_start_stats *stats = &sma6201->start_stats;
+	unsigned long flags;
+	ktime_t start;
+	s64 block_us;
 
 	switch (event) {
 	case SND_SOC_DAPM_PRE_PMU:
-		dev_info(component->dev, "%s : PRE_PMU\n", __func__);
+		dev_dbg(component->dev, "%s : PRE_PMU\n", __func__);
+
+		if (sma6201->force_amp_power_down == true)
+			break;
+
+		start = ktime_get();
+		spin_lock_irqsave(&stats->lock, flags);
+		stats->pmu_time = start;
+		stats->unmute_time = 0;
+		stats->trigger_time = 0;
+		spin_unlock_irqrestore(&stats->lock, flags);
 
-		if (sma6201->force_amp_power_down == false)
+		if (sma6201->async_startup)
+			sma6201_queue_startup(sma6201);
+		else
 			sma6201_startup(component);
+
+		block_us = ktime_us_delta(ktime_get(), start);
+		spin_lock_irqsave(&stats->lock, flags);
+		stats->last_block_us = block_us;
+		if (block_us > stats->max_block_us)
+			stats->max_block_us = block_us;
+		stats->total_block_us += block_us;
+		stats->blocks++;
+		spin_unlock_irqrestore(&stats->lock, flags);
 		break;
 
 	case SND_SOC_DAPM_POST_PMU:
-		dev_info(component->dev, "%s : POST_PMU\n", __func__);
+		dev_dbg(component->dev, "%s : POST_PMU\n", __func__);
 
 		break;
 
 	case SND_SOC_DAPM_PRE_PMD:
-		dev_info(component->dev, "%s : PRE_PMD\n", __func__);
+		dev_dbg(component->dev, "%s : PRE_PMD\n", __func__);
 
 		sma6201_shutdown(component);
 
 		break;
 
 	case SND_SOC_DAPM_POST_PMD:
-		dev_info(component->dev, "%s : POST_PMD\n", __func__);
+		dev_dbg(component->dev, "%s : POST_PMD\n", __func__);
 
 		break;
 	}
@@ -4444,43 +5485,50 @@ static int sma6201_adc_event(struct snd_soc_dapm_widget *w,
 	struct snd_soc_component *component =
 		snd_soc_dapm_to_component(w->dapm);
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	struct sma6201_txn_reg regs[8];
+	struct sma6201_txn txn;
+	ktime_t start = ktime_get();
+	int ret;
+
+	sma6201_txn_begin(sma6201, &txn, SMA6201_IO_DAPM, "adc_event", regs,
+			ARRAY_SIZE(regs));
 
 	switch (event) {
 	case SND_SOC_DAPM_PRE_PMU:
 		dev_info(component->dev,
 				"%s : DAC/ADC Feedback ON\n", __func__);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_09_OUTPUT_CTRL,
 				PORT_CONFIG_MASK|PORT_OUT_SEL_MASK,
 				OUTPUT_PORT_ENABLE|PIEZO_EQ);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_A2_TOP_MAN1, SDO_I2S_CH_MASK,
 				SDO_I2S_MONO);
 		/* even if Capture stream on, Mixer should turn on
 		 * SDO output(1:High-Z,0:Normal output)
 		 */
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_A3_TOP_MAN2, SDO_OUTPUT_MASK,
 				NORMAL_OUT);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_AE_TOP_MAN4, SDO_DATA_MODE_MASK,
 				SDO_DATA_MODE_48K);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_98_GENERAL_SETTING, ADC_PD_MASK,
 				ADC_OPERATION);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_9C_VOLUME_PGA_ISENSE, ADC_PGAVOL_MASK,
 				ADC_PGAVOL_X10);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_9D_ENABLE_ISENSE, ADC_CHOP_MASK,
 				ADC_CHOP_DIS);
 
 		if (sma6201->format == SND_SOC_DAIFMT_DSP_A) {
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_AE_TOP_MAN4, SDO_DATA_SEL_MASK,
 					SDO_DATA_DAC_ADC);
 		} else {
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_AE_TOP_MAN4, SDO_DATA_SEL_MASK,
 					SDO_DATA_ADC_DAC_24);
 		}
@@ -4489,16 +5537,21 @@ static int sma6201_adc_event(struct snd_soc_dapm_widget *w,
 	case SND_SOC_DAPM_PRE_PMD:
 		dev_info(component->dev,
 				"%s : DAC/ADC Feedback OFF\n", __func__);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_A3_TOP_MAN2, SDO_OUTPUT_MASK,
 				HIGH_Z_OUT);
-		regmap_update_bits(sma6201->regmap,
+		sma6201_txn_update(&txn,
 			SMA6201_98_GENERAL_SETTING, ADC_PD_MASK,
 				ADC_POWER_DOWN);
 		break;
 	}
 
-	return 0;
+	ret = sma6201_txn_commit(&txn);
+
+	if (event == SND_SOC_DAPM_PRE_PMU)
+		sma6201_phase_end(sma6201, SMA6201_PHASE_ADC_FEEDBACK, start);
+
+	return ret < 0 ? ret : 0;
 }
 
 static const struct snd_soc_dapm_widget sma6201_dapm_widgets[] = {
@@ -4521,14 +5574,63 @@ static const struct snd_soc_dapm_route sma6201_audio_map[] = {
 {"ADC", NULL, "SDO"},
 };
 
+/* Effective PLL reference clock for the stream parameters */
+static unsigned int sma6201_pll_ref_clk(struct sma6201_priv *sma6201,
+		struct snd_pcm_hw_params *params)
+{
+	if (sma6201->sys_clk_id == SMA6201_PLL_CLKIN_MCLK)
+		return sma6201->mclk_in;
+
+	return params_rate(params) * params_physical_width(params)
+					* params_channels(params);
+}
+
+/* PLL setting for an input clock, the table stays authoritative
+ * for the clocks it covers, others are solved once and kept
+ * in a small per device cache
+ */
+static const struct sma6201_pll_match *sma6201_find_pll_match(
+		struct sma6201_priv *sma6201, unsigned int input_clk)
+{
+	struct sma6201_pll_match *match;
+	int i, ret;
+
+	for (i = 0; i < sma6201->num_of_pll_matches; i++) {
+		if (sma6201->pll_matches[i].input_clk == input_clk)
+			return &sma6201->pll_matches[i];
+	}
+
+	for (i = 0; i < PLL_CACHE_SIZE; i++) {
+		if (sma6201->pll_cache[i].input_clk == input_clk)
+			return &sma6201->pll_cache[i];
+	}
+
+	match = &sma6201->pll_cache[sma6201->pll_cache_next];
+	ret = sma6201_solve_pll(input_clk, match);
+	if (ret) {
+		match->input_clk = 0;
+		dev_err(sma6201->dev, "%s : no PLL setting for %uHz (%d)\n",
+				__func__, input_clk, ret);
+		return NULL;
+	}
+	sma6201->pll_cache_next = (sma6201->pll_cache_next + 1) %
+		PLL_CACHE_SIZE;
+
+	dev_info(sma6201->dev,
+		"%s : %uHz - N 0x%02x F1 0x%02x F2 0x%02x F3_P_CP 0x%02x\n",
+		__func__, input_clk, match->n, match->f1, match->f2,
+		match->f3_p_cp);
+
+	return match;
+}
+
 static int sma6201_setup_pll(struct snd_soc_component *component,
 		struct snd_pcm_hw_params *params)
 {
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-	int i = 0;
-	bool pll_set_flag = false;
-	int calc_to_bclk = params_rate(params) * params_physical_width(params)
-					* params_channels(params);
+	const struct sma6201_pll_match *match = NULL;
+	int calc_to_bclk = sma6201_pll_ref_clk(sma6201, params);
+	ktime_t start = ktime_get();
 
 	dev_info(component->dev, "%s : rate = %d : bit size = %d : channel = %d\n",
 		__func__, params_rate(params), params_physical_width(params),
@@ -4545,52 +5647,94 @@ static int sma6201_setup_pll(struct snd_soc_component *component,
 		/* PLL operation, PLL Clock, External Clock,
 		 * PLL reference PLL_REF_CLK1 clock
 		 */
-		regmap_update_bits(sma6201->regmap, SMA6201_A2_TOP_MAN1,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_SETUP_PLL,
+		SMA6201_A2_TOP_MAN1,
 		PLL_PD_MASK|MCLK_SEL_MASK|PLL_REF_CLK1_MASK|PLL_REF_CLK2_MASK,
 		PLL_OPERATION|PLL_CLK|REF_EXTERNAL_CLK|PLL_REF_CLK1);
 
-		for (i = 0; i < sma6201->num_of_pll_matches; i++) {
-			if (sma6201->pll_matches[i].input_clk ==
-					sma6201->mclk_in) {
-				pll_set_flag = true;
-				break;
-			}
-		}
+		match = sma6201_find_pll_match(sma6201, sma6201->mclk_in);
 	} else if (sma6201->sys_clk_id == SMA6201_PLL_CLKIN_BCLK) {
 		/* SCK clock monitoring mode */
-		regmap_update_bits(sma6201->regmap, SMA6201_A7_TOP_MAN3,
-				CLOCK_MON_SEL_MASK, CLOCK_MON_SCK);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_SETUP_PLL,
+				SMA6201_A7_TOP_MAN3, CLOCK_MON_SEL_MASK,
+				CLOCK_MON_SCK);
 
 		/* PLL operation, PLL Clock, External Clock,
 		 * PLL reference SCK clock
 		 */
-		regmap_update_bits(sma6201->regmap, SMA6201_A2_TOP_MAN1,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_SETUP_PLL,
+		SMA6201_A2_TOP_MAN1,
 		PLL_PD_MASK|MCLK_SEL_MASK|PLL_REF_CLK1_MASK|PLL_REF_CLK2_MASK,
 		PLL_OPERATION|PLL_CLK|REF_EXTERNAL_CLK|PLL_SCK);
 
-		for (i = 0; i < sma6201->num_of_pll_matches; i++) {
-			if (sma6201->pll_matches[i].input_clk ==
-					calc_to_bclk) {
-				pll_set_flag = true;
-				break;
-			}
-		}
+		match = sma6201_find_pll_match(sma6201, calc_to_bclk);
 	}
-	if (pll_set_flag != true) {
+	if (!match) {
 		dev_err(component->dev, "PLL internal table and external clock do not match");
-		i = PLL_DEFAULT_SET;
+		match = &sma6201->pll_matches[PLL_DEFAULT_SET];
+	}
+
+	sma6201_io_write(sma6201, SMA6201_IO_SETUP_PLL, SMA6201_8B_PLL_POST_N,
+			match->post_n);
+	sma6201_io_write(sma6201, SMA6201_IO_SETUP_PLL, SMA6201_8C_PLL_N,
+			match->n);
+	sma6201_io_write(sma6201, SMA6201_IO_SETUP_PLL, SMA6201_8D_PLL_F1,
+			match->f1);
+	sma6201_io_write(sma6201, SMA6201_IO_SETUP_PLL, SMA6201_8E_PLL_F2,
+			match->f2);
+	sma6201_io_write(sma6201, SMA6201_IO_SETUP_PLL, SMA6201_8F_PLL_F3_P_CP,
+			match->f3_p_cp);
+
+	/* The sigma delta modulation is needed for the fractional divider.
+	 * The PLL setup owns the SDM PD bit, there is no mixer control on it.
+	 */
+	sma6201_io_update_bits(sma6201, SMA6201_IO_SETUP_PLL,
+			SMA6201_A3_TOP_MAN2, PLL_SDM_PD_MASK,
+			(match->f1 || match->f2 || (match->f3_p_cp & PLL_F3_MASK)) ?
+			SDM_ON : SDM_OFF);
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_SETUP_PLL, start);
+
+	return 0;
+}
+
+/* Reprogram the PLL while the boost stays up. The output is muted
+ * over the relock and unmuted again if the amp was playing.
+ */
+static int sma6201_retune_pll(struct snd_soc_component *component,
+		struct snd_pcm_hw_params *params)
+{
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	unsigned int status;
+	int ret;
+
+	dev_info(component->dev, "%s\n", __func__);
+
+	if (sma6201->amp_power_status &&
+		sma6201_shadow_update(sma6201, SMA6201_IO_SETUP_PLL,
+			SMA6201_SHADOW_MUTE, SPK_MUTE) > 0)
+		sma6201->mute_time = ktime_get();
+	sma6201_wait_mute_slope(sma6201);
+
+	ret = sma6201_setup_pll(component, params);
+	if (ret)
+		return ret;
+
+	/* Clock monitor is cleared once the PLL output is back,
+	 * the amp stays muted if it is not
+	 */
+	ret = sma6201_io_read_poll_timeout(sma6201, SMA6201_IO_SETUP_PLL,
+			SMA6201_FB_STATUS2, status,
+			!(status & CLOCK_MON_STATUS), PLL_LOCK_POLL_US,
+			PLL_LOCK_TIMEOUT_US);
+	if (ret) {
+		dev_err(component->dev, "%s : PLL not locked %d\n",
+				__func__, ret);
+		return ret;
 	}
 
-	regmap_write(sma6201->regmap, SMA6201_8B_PLL_POST_N,
-			sma6201->pll_matches[i].post_n);
-	regmap_write(sma6201->regmap, SMA6201_8C_PLL_N,
-			sma6201->pll_matches[i].n);
-	regmap_write(sma6201->regmap, SMA6201_8D_PLL_F1,
-			sma6201->pll_matches[i].f1);
-	regmap_write(sma6201->regmap, SMA6201_8E_PLL_F2,
-			sma6201->pll_matches[i].f2);
-	regmap_write(sma6201->regmap, SMA6201_8F_PLL_F3_P_CP,
-			sma6201->pll_matches[i].f3_p_cp);
+	if (sma6201->amp_power_status)
+		sma6201_unmute(sma6201, SMA6201_IO_SETUP_PLL);
 
 	return 0;
 }
@@ -4600,8 +5744,11 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 {
 	struct snd_soc_component *component = dai->component;
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
-	unsigned int input_format = 0;
-	bool delayed_shutdown_flag = sma6201->delayed_shutdown_enable;
+	unsigned int input_format = 0, ref_clk;
+	struct sma6201_txn_reg regs[6];
+	struct sma6201_txn txn;
+	ktime_t start = ktime_get();
+	int ret;
 
 	dev_info(component->dev, "%s : rate = %d : bit size = %d\n",
 		__func__, params_rate(params), params_width(params));
@@ -4624,28 +5771,35 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			(sma6201->sys_clk_id == SMA6201_PLL_CLKIN_MCLK
 			|| sma6201->sys_clk_id == SMA6201_PLL_CLKIN_BCLK)) {
 
-			if (sma6201->last_rate != params_rate(params) ||
-				sma6201->last_width !=
-					params_physical_width(params) ||
-				sma6201->last_channel !=
-					params_channels(params)) {
-
-				if (sma6201->delayed_shutdown_enable)
-					sma6201->delayed_shutdown_enable =
-						false;
-				sma6201_shutdown(component);
-				sma6201->delayed_shutdown_enable =
-					delayed_shutdown_flag;
-
-				sma6201_setup_pll(component, params);
-				sma6201_startup(component);
-
-				sma6201->last_rate =
-					params_rate(params);
-				sma6201->last_width =
-					params_physical_width(params);
-				sma6201->last_channel =
-					params_channels(params);
+			/* Only a new reference clock needs the PLL again,
+			 * a powered amp is retuned without a power cycle
+			 */
+			ref_clk = sma6201_pll_ref_clk(sma6201, params);
+			if (sma6201->pll_ref_clk != ref_clk) {
+				ret = sma6201_wait_startup_done(sma6201);
+				if (ret)
+					goto out;
+				/* Keep a pending autosuspend off the retune */
+				ret = pm_runtime_get_sync(component->dev);
+				if (ret < 0) {
+					pm_runtime_put_noidle(component->dev);
+					goto out;
+				}
+				if (sma6201_amp_powered(sma6201,
+						SMA6201_IO_HW_PARAMS))
+					ret = sma6201_retune_pll(component,
+							params);
+				else
+					ret = sma6201_setup_pll(component,
+							params);
+				if (!ret)
+					ret = sma6201_startup(component);
+				pm_runtime_mark_last_busy(component->dev);
+				pm_runtime_put_autosuspend(component->dev);
+				if (ret)
+					goto out;
+
+				sma6201->pll_ref_clk = ref_clk;
 			}
 		}
 
@@ -4660,6 +5814,9 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			atomic_set(&sma6201->irq_enabled, true);
 		}
 
+		sma6201_txn_begin(sma6201, &txn, SMA6201_IO_HW_PARAMS,
+				"hw_params", regs, ARRAY_SIZE(regs));
+
 		switch (params_rate(params)) {
 		case 8000:
 		case 12000:
@@ -4669,16 +5826,16 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 		case 44100:
 		case 48000:
 		case 96000:
-		regmap_update_bits(sma6201->regmap, SMA6201_A2_TOP_MAN1,
+		sma6201_txn_update(&txn, SMA6201_A2_TOP_MAN1,
 				DAC_DN_CONV_MASK, DAC_DN_CONV_DISABLE);
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+		sma6201_txn_update(&txn, SMA6201_01_INPUT1_CTRL1,
 				LEFTPOL_MASK, LOW_FIRST_CH);
 		break;
 
 		case 192000:
-		regmap_update_bits(sma6201->regmap, SMA6201_A2_TOP_MAN1,
+		sma6201_txn_update(&txn, SMA6201_A2_TOP_MAN1,
 				DAC_DN_CONV_MASK, DAC_DN_CONV_ENABLE);
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+		sma6201_txn_update(&txn, SMA6201_01_INPUT1_CTRL1,
 				LEFTPOL_MASK, HIGH_FIRST_CH);
 		break;
 
@@ -4686,22 +5843,23 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			dev_err(component->dev, "%s not support rate : %d\n",
 				__func__, params_rate(params));
 
-		return -EINVAL;
+		ret = -EINVAL;
+		goto out;
 		}
 
 		/* Setting TDM Rx operation */
 		if (sma6201->format == SND_SOC_DAIFMT_DSP_A) {
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_A4_SDO_OUT_FMT,
 				O_FORMAT_MASK, O_FORMAT_TDM);
 
 			switch (params_physical_width(params)) {
 			case 16:
-			regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+			sma6201_txn_update(&txn, SMA6201_A6_TDM2,
 					TDM_DL_MASK, TDM_DL_16);
 			break;
 			case 32:
-			regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+			sma6201_txn_update(&txn, SMA6201_A6_TDM2,
 					TDM_DL_MASK, TDM_DL_32);
 			break;
 			default:
@@ -4711,11 +5869,11 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 
 			switch (params_channels(params)) {
 			case 4:
-			regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+			sma6201_txn_update(&txn, SMA6201_A6_TDM2,
 					TDM_N_SLOT_MASK, TDM_N_SLOT_4);
 			break;
 			case 8:
-			regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+			sma6201_txn_update(&txn, SMA6201_A6_TDM2,
 					TDM_N_SLOT_MASK, TDM_N_SLOT_8);
 			break;
 			default:
@@ -4727,24 +5885,26 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			 */
 			switch (params_physical_width(params)) {
 			case 16:
-			regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+			sma6201_txn_update(&txn, SMA6201_A5_TDM1,
 					TDM_16BIT_SLOT1_RX_POS_MASK,
 					TDM_16BIT_SLOT1_RX_POS_0);
-			regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+			sma6201_txn_update(&txn, SMA6201_A5_TDM1,
 					TDM_16BIT_SLOT2_RX_POS_MASK,
 					TDM_16BIT_SLOT2_RX_POS_1);
 			break;
 			case 32:
-			regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+			sma6201_txn_update(&txn, SMA6201_A5_TDM1,
 					TDM_32BIT_SLOT1_RX_POS_MASK,
 					TDM_32BIT_SLOT1_RX_POS_0);
-			regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+			sma6201_txn_update(&txn, SMA6201_A5_TDM1,
 					TDM_32BIT_SLOT2_RX_POS_MASK,
 					TDM_32BIT_SLOT2_RX_POS_1);
 			}
 		}
 	/* Substream->stream is SNDRV_PCM_STREAM_CAPTURE */
 	} else {
+		sma6201_txn_begin(sma6201, &txn, SMA6201_IO_HW_PARAMS,
+				"hw_params", regs, ARRAY_SIZE(regs));
 
 		switch (params_format(params)) {
 
@@ -4752,10 +5912,10 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			dev_info(component->dev,
 				"%s set format SNDRV_PCM_FORMAT_S16_LE\n",
 				__func__);
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_A4_SDO_OUT_FMT, WD_LENGTH_MASK,
 					WL_16BIT);
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_A4_SDO_OUT_FMT, SCK_RATE_MASK,
 					SCK_RATE_32FS);
 			break;
@@ -4764,10 +5924,10 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			dev_info(component->dev,
 				"%s set format SNDRV_PCM_FORMAT_S24_LE\n",
 				__func__);
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_A4_SDO_OUT_FMT, WD_LENGTH_MASK,
 					WL_24BIT);
-			regmap_update_bits(sma6201->regmap,
+			sma6201_txn_update(&txn,
 				SMA6201_A4_SDO_OUT_FMT, SCK_RATE_MASK,
 					SCK_RATE_64FS);
 
@@ -4777,22 +5937,23 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 			dev_err(component->dev,
 				"%s not support data bit : %d\n", __func__,
 						params_format(params));
-			return -EINVAL;
+			ret = -EINVAL;
+			goto out;
 		}
 
 		/* Setting TDM Tx operation */
 		if (sma6201->format == SND_SOC_DAIFMT_DSP_A) {
-			regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+			sma6201_txn_update(&txn, SMA6201_A5_TDM1,
 					TDM_CLK_POL_MASK, TDM_CLK_POL_RISE);
-			regmap_update_bits(sma6201->regmap, SMA6201_A5_TDM1,
+			sma6201_txn_update(&txn, SMA6201_A5_TDM1,
 					TDM_TX_MODE_MASK, TDM_TX_STEREO);
 			/* Select a slot to process TDM Tx data
 			 * (Default slot0, slot1)
 			 */
-			regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+			sma6201_txn_update(&txn, SMA6201_A6_TDM2,
 					TDM_SLOT1_TX_POS_MASK,
 					TDM_SLOT1_TX_POS_0);
-			regmap_update_bits(sma6201->regmap, SMA6201_A6_TDM2,
+			sma6201_txn_update(&txn, SMA6201_A6_TDM2,
 					TDM_SLOT2_TX_POS_MASK,
 					TDM_SLOT2_TX_POS_1);
 		}
@@ -4830,13 +5991,18 @@ static int sma6201_dai_hw_params_amp(struct snd_pcm_substream *substream,
 		dev_err(component->dev,
 			"%s not support data bit : %d\n", __func__,
 					params_format(params));
-		return -EINVAL;
+		ret = -EINVAL;
+		goto out;
 	}
 
-	regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+	sma6201_txn_update(&txn, SMA6201_01_INPUT1_CTRL1,
 				I2S_MODE_MASK, input_format);
 
-	return 0;
+	ret = sma6201_txn_commit(&txn);
+out:
+	sma6201_phase_end(sma6201, SMA6201_PHASE_HW_PARAMS, start);
+
+	return ret < 0 ? ret : 0;
 }
 
 static int sma6201_dai_set_sysclk_amp(struct snd_soc_dai *dai,
@@ -4853,13 +6019,15 @@ static int sma6201_dai_set_sysclk_amp(struct snd_soc_dai *dai,
 
 	switch (clk_id) {
 	case SMA6201_EXTERNAL_CLOCK_19_2:
-		regmap_update_bits(sma6201->regmap, SMA6201_00_SYSTEM_CTRL,
-				CLKSYSTEM_MASK, EXT_19_2);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+				SMA6201_00_SYSTEM_CTRL, CLKSYSTEM_MASK,
+				EXT_19_2);
 		break;
 
 	case SMA6201_EXTERNAL_CLOCK_24_576:
-		regmap_update_bits(sma6201->regmap, SMA6201_00_SYSTEM_CTRL,
-				CLKSYSTEM_MASK, EXT_24_576);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+				SMA6201_00_SYSTEM_CTRL, CLKSYSTEM_MASK,
+				EXT_24_576);
 		break;
 	case SMA6201_PLL_CLKIN_MCLK:
 		if (freq < 1536000 || freq > 24576000) {
@@ -4885,24 +6053,29 @@ static int sma6201_dai_digital_mute(struct snd_soc_dai *component_dai, int mute)
 	struct snd_soc_component *component = component_dai->component;
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 
+	/* Kept for a startup still in progress, sma6201_power_up
+	 * leaves the output muted when the DAI asked for it
+	 */
+	mutex_lock(&sma6201->mute_lock);
+	sma6201->dai_mute = mute;
+
 	if (!(sma6201->amp_power_status)) {
-		dev_info(component->dev, "%s : %s\n",
+		dev_dbg(component->dev, "%s : %s\n",
 			__func__, "Already AMP Shutdown");
-		return 0;
+		goto out;
 	}
 
-	if (mute) {
-		dev_info(component->dev, "%s : %s\n", __func__, "MUTE");
+	dev_dbg(component->dev, "%s : %s\n", __func__,
+			mute ? "MUTE" : "UNMUTE");
 
-		regmap_update_bits(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL,
-					SPK_MUTE_MASK, SPK_MUTE);
-
-	} else {
-		dev_info(component->dev, "%s : %s\n", __func__, "UNMUTE");
-
-		regmap_update_bits(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL,
-					SPK_MUTE_MASK, SPK_UNMUTE);
-	}
+	/* Repeated calls stop at the shadow, the mute slope starts
+	 * at the call that actually muted
+	 */
+	if (sma6201_shadow_update(sma6201, SMA6201_IO_DAI, SMA6201_SHADOW_MUTE,
+			mute ? SPK_MUTE : SPK_UNMUTE) > 0 && mute)
+		sma6201->mute_time = ktime_get();
+out:
+	mutex_unlock(&sma6201->mute_lock);
 
 	return 0;
 }
@@ -4918,19 +6091,23 @@ static int sma6201_dai_set_fmt_amp(struct snd_soc_dai *component_dai,
 	case SND_SOC_DAIFMT_CBS_CFS:
 		dev_info(component->dev, "%s : %s\n", __func__, "Slave mode");
 		/* I2S/TDM clock mode - Slave mode */
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_01_INPUT1_CTRL1,
 					MASTER_SLAVE_MASK, SLAVE_MODE);
-		regmap_update_bits(sma6201->regmap, SMA6201_A7_TOP_MAN3,
-					MAS_EN_MASK, MAS_EN_SLAVE);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_A7_TOP_MAN3, MAS_EN_MASK,
+					MAS_EN_SLAVE);
 		break;
 
 	case SND_SOC_DAIFMT_CBM_CFM:
 		dev_info(component->dev, "%s : %s\n", __func__, "Master mode");
 		/* I2S/TDM clock mode - Master mode */
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_01_INPUT1_CTRL1,
 					MASTER_SLAVE_MASK, MASTER_MODE);
-		regmap_update_bits(sma6201->regmap, SMA6201_A7_TOP_MAN3,
-					MAS_EN_MASK, MAS_EN_MASTER);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_A7_TOP_MAN3, MAS_EN_MASK,
+					MAS_EN_MASTER);
 		break;
 
 	default:
@@ -4959,21 +6136,24 @@ static int sma6201_dai_set_fmt_amp(struct snd_soc_dai *component_dai,
 	case SND_SOC_DAIFMT_IB_NF:
 		dev_info(component->dev, "%s : %s\n",
 			__func__, "Invert BCLK + Normal Frame");
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_01_INPUT1_CTRL1,
 					SCK_RISING_MASK, SCK_RISING_EDGE);
 		break;
 	case SND_SOC_DAIFMT_IB_IF:
 		dev_info(component->dev, "%s : %s\n",
 			__func__, "Invert BCLK + Invert Frame");
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_01_INPUT1_CTRL1,
 					LEFTPOL_MASK|SCK_RISING_MASK,
 					HIGH_FIRST_CH|SCK_RISING_EDGE);
 		break;
 	case SND_SOC_DAIFMT_NB_IF:
 		dev_info(component->dev, "%s : %s\n",
 			__func__, "Normal BCLK + Invert Frame");
-		regmap_update_bits(sma6201->regmap, SMA6201_01_INPUT1_CTRL1,
-					LEFTPOL_MASK, HIGH_FIRST_CH);
+		sma6201_io_update_bits(sma6201, SMA6201_IO_DAI,
+					SMA6201_01_INPUT1_CTRL1, LEFTPOL_MASK,
+					HIGH_FIRST_CH);
 		break;
 	case SND_SOC_DAIFMT_NB_NF:
 		dev_info(component->dev, "%s : %s\n",
@@ -4988,11 +6168,32 @@ static int sma6201_dai_set_fmt_amp(struct snd_soc_dai *component_dai,
 	return 0;
 }
 
+static int sma6201_dai_trigger(struct snd_pcm_substream *substream,
+		int cmd, struct snd_soc_dai *component_dai)
+{
+	struct snd_soc_component *component = component_dai->component;
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+
+	if (substream->stream != SNDRV_PCM_STREAM_PLAYBACK)
+		return 0;
+
+	switch (cmd) {
+	case SNDRV_PCM_TRIGGER_START:
+	case SNDRV_PCM_TRIGGER_RESUME:
+	case SNDRV_PCM_TRIGGER_PAUSE_RELEASE:
+		sma6201_start_account(sma6201, true);
+		break;
+	}
+
+	return 0;
+}
+
 static const struct snd_soc_dai_ops sma6201_dai_ops_amp = {
 	.set_sysclk = sma6201_dai_set_sysclk_amp,
 	.set_fmt = sma6201_dai_set_fmt_amp,
 	.hw_params = sma6201_dai_hw_params_amp,
 	.digital_mute = sma6201_dai_digital_mute,
+	.trigger = sma6201_dai_trigger,
 };
 
 #define SMA6201_RATES SNDRV_PCM_RATE_8000_192000
@@ -5024,11 +6225,15 @@ static struct snd_soc_dai_driver sma6201_dai[] = {
 static int sma6201_set_bias_level(struct snd_soc_component *component,
 			enum snd_soc_bias_level level)
 {
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	enum snd_soc_bias_level cur = snd_soc_component_get_bias_level(component);
+	int ret;
+
 	switch (level) {
 	case SND_SOC_BIAS_ON:
 
+		/* AMP power follows the DAC widget, not the capture path */
 		dev_info(component->dev, "%s\n", "SND_SOC_BIAS_ON");
-		sma6201_startup(component);
 
 		break;
 
@@ -5036,12 +6241,35 @@ static int sma6201_set_bias_level(struct snd_soc_component *component,
 
 		dev_info(component->dev, "%s\n", "SND_SOC_BIAS_PREPARE");
 
+		/* Stream start : resume registers ahead of the DAC event.
+		 * On failure the bias stays STANDBY, no reference is kept.
+		 */
+		if (cur == SND_SOC_BIAS_STANDBY) {
+			ret = pm_runtime_get_sync(component->dev);
+			if (ret < 0) {
+				dev_err(component->dev, "%s : resume fail %d\n",
+						__func__, ret);
+				pm_runtime_put_noidle(component->dev);
+				return ret;
+			}
+		}
+
 		break;
 
 	case SND_SOC_BIAS_STANDBY:
 
 		dev_info(component->dev, "%s\n", "SND_SOC_BIAS_STANDBY");
 
+		/* Stream end : warm standby until autosuspend */
+		if (cur == SND_SOC_BIAS_PREPARE) {
+			if (!sma6201->amp_power_status &&
+				sma6201->warm_standby_time > 0)
+				mod_delayed_work(system_freezable_wq,
+					&sma6201->standby_work, 0);
+			pm_runtime_mark_last_busy(component->dev);
+			pm_runtime_put_autosuspend(component->dev);
+		}
+
 		break;
 
 	case SND_SOC_BIAS_OFF:
@@ -5055,36 +6283,47 @@ static int sma6201_set_bias_level(struct snd_soc_component *component,
 	return 0;
 }
 
-static irqreturn_t sma6201_isr(int irq, void *data)
+/* Read the status block(0xFA ~ 0xFF) in a single burst */
+static int sma6201_read_status(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, struct sma6201_status *status)
 {
-	struct sma6201_priv *sma6201 = (struct sma6201_priv *) data;
+	u8 buf[SMA6201_FF_VERSION - SMA6201_FA_STATUS1 + 1];
 	int ret;
-	unsigned int over_temp, ocp_val, sar_adc, bop_state;
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FA_STATUS1, &over_temp);
+	ret = sma6201_io_bulk_read(sma6201, site, SMA6201_FA_STATUS1,
+			buf, ARRAY_SIZE(buf));
 	if (ret != 0) {
 		dev_err(sma6201->dev,
-			"failed to read SMA6201_FA_STATUS1 : %d\n", ret);
+			"failed to read SMA6201_FA_STATUS1 ~ FF_VERSION : %d\n",
+				ret);
+		return ret;
 	}
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FB_STATUS2, &ocp_val);
-	if (ret != 0) {
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FB_STATUS2 : %d\n", ret);
-	}
+	status->over_temp = buf[SMA6201_FA_STATUS1 - SMA6201_FA_STATUS1];
+	status->ocp_val = buf[SMA6201_FB_STATUS2 - SMA6201_FA_STATUS1];
+	status->sar_adc = buf[SMA6201_FC_STATUS3 - SMA6201_FA_STATUS1];
+	status->status4 = buf[SMA6201_FD_STATUS4 - SMA6201_FA_STATUS1];
+	status->bop_state = buf[SMA6201_FE_STATUS5 - SMA6201_FA_STATUS1];
+	status->version = buf[SMA6201_FF_VERSION - SMA6201_FA_STATUS1];
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FC_STATUS3, &sar_adc);
-	if (ret != 0) {
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FC_STATUS3 : %d\n", ret);
-	}
+	return 0;
+}
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FE_STATUS5, &bop_state);
-	if (ret != 0) {
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FE_STATUS5 : %d\n", ret);
+static irqreturn_t sma6201_isr(int irq, void *data)
+{
+	struct sma6201_priv *sma6201 = (struct sma6201_priv *) data;
+	struct sma6201_status status;
+	unsigned int over_temp, ocp_val, sar_adc, bop_state;
+	int ret;
+
+	ret = sma6201_read_status(sma6201, SMA6201_IO_ISR, &status);
+	if (ret != 0)
 		return IRQ_HANDLED;
-	}
+
+	over_temp = status.over_temp;
+	ocp_val = status.ocp_val;
+	sar_adc = status.sar_adc;
+	bop_state = status.bop_state;
 
 	dev_crit(sma6201->dev,
 			"%s : SAR_ADC : %x\n", __func__, sar_adc);
@@ -5099,7 +6338,8 @@ static irqreturn_t sma6201_isr(int irq, void *data)
 			"%s : OCP_SPK(Over Current Protect SPK)\n", __func__);
 		if (sma6201->enable_ocp_aging) {
 			mutex_lock(&sma6201->lock);
-			sma6201_thermal_compensation(sma6201, true);
+			sma6201_thermal_compensation(sma6201, SMA6201_IO_ISR,
+					true);
 			mutex_unlock(&sma6201->lock);
 		}
 		sma6201->ocp_count++;
@@ -5127,27 +6367,18 @@ static void sma6201_check_thermal_fault_worker(struct work_struct *work)
 	struct sma6201_priv *sma6201 =
 		container_of(work, struct sma6201_priv,
 				check_thermal_fault_work.work);
-	int ret;
+	struct sma6201_status status;
 	unsigned int over_temp, sar_adc, bop_state;
 	unsigned int bop_threshold = 143;
+	int ret;
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FA_STATUS1, &over_temp);
-	if (ret != 0) {
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FA_STATUS1 : %d\n", ret);
+	ret = sma6201_read_status(sma6201, SMA6201_IO_FAULT_WORKER, &status);
+	if (ret != 0)
 		return;
-	}
-	ret = regmap_read(sma6201->regmap, SMA6201_FC_STATUS3, &sar_adc);
-	if (ret != 0) {
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FC_STATUS3 : %d\n", ret);
-	}
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FE_STATUS5, &bop_state);
-	if (ret != 0) {
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FE_STATUS5 : %d\n", ret);
-	}
+	over_temp = status.over_temp;
+	sar_adc = status.sar_adc;
+	bop_state = status.bop_state;
 
 	if (bop_state != 0 || sar_adc <= bop_threshold) {
 		/* Expected brown out operation */
@@ -5173,219 +6404,513 @@ static void sma6201_check_thermal_fault_worker(struct work_struct *work)
 	}
 }
 
-static void sma6201_check_thermal_vbat_worker(struct work_struct *work)
+/* Thermal zone of the compensation, selected by thermal_sense_opt
+ * quiet_therm : skin-therm, piezo_therm : wp-therm, vts : vts-virt-therm
+ */
+static const char *sma6201_thermal_zone_name(struct sma6201_priv *sma6201)
 {
-	struct sma6201_priv *sma6201 =
-		container_of(work, struct sma6201_priv,
-			check_thermal_vbat_work.work);
-#ifdef CONFIG_SMA6201_BATTERY_READING
-	union power_supply_propval prop = {0, };
-	int ret = 0;
+#ifndef CONFIG_MACH_PIEZO
+	return "quiet_therm";
+#else
+	if (sma6201->thermal_sense_opt == 2)
+		return "wp-therm";
+
+	return "skin-therm";
 #endif
-	struct outside_status fifo_buf_in = {0, };
+}
 
-	mutex_lock(&sma6201->lock);
+/* Compensation gain of the battery level, sma6201->lock held */
+static int sma6201_vbat_gain(struct sma6201_priv *sma6201)
+{
+	if (sma6201->vbat_status < 0 ||
+		sma6201->vbat_status >= VBAT_TABLE_NUM)
+		return 0;
 
-	if (sma6201->thermal_sense_opt == -1) {
+	return sma6201_vbat_gain_matches[sma6201->vbat_status].comp_gain;
+}
 
-#ifndef CONFIG_MACH_PIEZO
-		sma6201->tz_sense =
-			thermal_zone_get_zone_by_name("quiet_therm");
-#else
-		/* Function for checking thermal
-		 * quiet_therm : skin-therm,
-		 * piezo_therm : wp-therm, vts : vts-virt-therm
-		 */
-		sma6201->tz_sense =
-			thermal_zone_get_zone_by_name("skin-therm");
-#endif
-	} else {
+#ifdef CONFIG_SMA6201_BATTERY_READING
+/* Battery level of the filtered voltage. Going back up a level needs
+ * VBAT_HYST_MV above its limit, a voltage sitting on a limit would
+ * toggle the gain otherwise.
+ */
+static int sma6201_vbat_level(struct sma6201_priv *sma6201)
+{
+	int i, limit;
 
-#ifndef CONFIG_MACH_PIEZO
-		sma6201->tz_sense =
-			thermal_zone_get_zone_by_name("quiet_therm");
-#else
-		/* Function for checking thermal
-		 * quiet_therm : skin-therm,
-		 * piezo_therm : wp-therm, vts : vts-virt-therm
-		 */
-		switch (sma6201->thermal_sense_opt) {
-		case 1:
-			sma6201->tz_sense =
-				thermal_zone_get_zone_by_name("skin-therm");
-			break;
-		case 2:
-			sma6201->tz_sense =
-				thermal_zone_get_zone_by_name("wp-therm");
+	for (i = 0; i < VBAT_TABLE_NUM - 1; i++) {
+		limit = sma6201_vbat_gain_matches[i].vbat_limit_mV;
+		if (sma6201->vbat_status >= 0 && i < sma6201->vbat_status)
+			limit += VBAT_HYST_MV;
+		if (sma6201->vbat_mV >= limit)
 			break;
-		default:
-			sma6201->tz_sense =
-				thermal_zone_get_zone_by_name("skin-therm");
-			break;
-		}
-#endif
 	}
 
-	if (IS_ERR(sma6201->tz_sense))
-		dev_info(sma6201->dev, "%s : need to check thermal zone name:%p\n",
-			__func__, sma6201->tz_sense);
-	else
-		thermal_zone_get_temp(sma6201->tz_sense,
-			&fifo_buf_in.thermal_deg);
+	return i;
+}
 
-#ifdef CONFIG_MACH_PIEZO
-	/* Converting xxxxx mC to xx.x C */
-	fifo_buf_in.thermal_deg = fifo_buf_in.thermal_deg/100;
-#else
-	fifo_buf_in.thermal_deg = fifo_buf_in.thermal_deg*10;
-#endif
+/* Called in atomic context, the supply is read from vbat_work */
+static int sma6201_psy_notifier(struct notifier_block *nb,
+		unsigned long event, void *data)
+{
+	struct sma6201_priv *sma6201 =
+		container_of(nb, struct sma6201_priv, psy_nb);
+	struct power_supply *psy = data;
 
-/* Currently not checked Battery level */
-#ifdef CONFIG_SMA6201_BATTERY_READING
-	sma6201->batt_psy = power_supply_get_by_name("battery");
+	if (event == PSY_EVENT_PROP_CHANGED &&
+		!strcmp(psy->desc->name, "battery"))
+		queue_work(system_freezable_wq, &sma6201->vbat_work);
+
+	return NOTIFY_OK;
+}
+
+static void sma6201_vbat_worker(struct work_struct *work)
+{
+	struct sma6201_priv *sma6201 =
+		container_of(work, struct sma6201_priv, vbat_work);
+	union power_supply_propval prop = {0, };
+	int i, level, gain, ret;
+
+	mutex_lock(&sma6201->lock);
 
 	if (!sma6201->batt_psy) {
-		pr_err("failed get batt_psy\n");
-		goto exit_vbat_worker;
+		sma6201->batt_psy = power_supply_get_by_name("battery");
+		if (!sma6201->batt_psy) {
+			dev_dbg(sma6201->dev, "%s : failed get batt_psy\n",
+				__func__);
+			goto out;
+		}
 	}
+
 	ret = power_supply_get_property(sma6201->batt_psy,
 		POWER_SUPPLY_PROP_VOLTAGE_NOW, &prop);
 	if (ret < 0) {
-		pr_err("Error in getting battery voltage, ret=%d\n", ret);
-		fifo_buf_in.batt_voltage_mV = 4450;
-	} else
-		fifo_buf_in.batt_voltage_mV = prop.intval;
-#endif
+		dev_dbg(sma6201->dev, "%s : battery voltage read fail %d\n",
+			__func__, ret);
+		if (ret == -ENODEV) {
+			/* Supply unregistered, look it up again */
+			power_supply_put(sma6201->batt_psy);
+			sma6201->batt_psy = NULL;
+		}
+		goto out;
+	}
 
-	fifo_buf_in.id = sma6201->fifo_count;
+	/* uV to mV, the first sample seeds the filter */
+	if (!sma6201->vbat_mV)
+		sma6201->vbat_mV = prop.intval / 1000;
+	else
+		sma6201->vbat_mV += (prop.intval / 1000 - sma6201->vbat_mV) /
+			VBAT_FILTER_WEIGHT;
 
-	if (!kfifo_is_full(&sma6201->data_fifo)) {
-		kfifo_in(&sma6201->data_fifo,
-			(unsigned char *)&fifo_buf_in,
-			sizeof(fifo_buf_in));
+	level = sma6201_vbat_level(sma6201);
+	if (level == sma6201->vbat_status)
+		goto out;
 
-		sma6201->fifo_count++;
-		pr_debug("%s :queue in", __func__);
-	}
+	sma6201->vbat_status = level;
+	dev_info(sma6201->dev, "%s : battery %d mV, %s\n", __func__,
+		sma6201->vbat_mV, sma6201_vbat_gain_matches[level].lvl_name);
 
-#ifdef CONFIG_SMA6201_BATTERY_READING
-	dev_dbg(sma6201->dev,
-	"%s : id - [%d]  sense_temp - [%3d] deg bat_vol - [%d] mV\n",
-	__func__, fifo_buf_in.id,
-	fifo_buf_in.thermal_deg,
-	fifo_buf_in.batt_voltage_mV/1000);
-#else
-	dev_dbg(sma6201->dev,
-	"%s : id - [%d]  sense_temp - [%3d]\n",
-	__func__, fifo_buf_in.id,
-	fifo_buf_in.thermal_deg);
-#endif
-	sma6201_thermal_compensation(sma6201, false);
+	/* Only compensation for music playback, the larger of the battery
+	 * and the current temperature row gain
+	 */
+	if (sma6201->check_thermal_vbat_enable &&
+		sma6201->voice_music_class_h_mode ==
+			SMA6201_CLASS_H_MUSIC_MODE) {
+		i = sma6201->threshold_level;
+		gain = sma6201_vbat_gain(sma6201);
+		if (i > 0 && i < sma6201->num_of_temperature_matches &&
+			sma6201->temp_match[i].activate)
+			gain = max(gain, sma6201->temp_match[i].comp_gain);
 
-#ifdef CONFIG_SMA6201_BATTERY_READING
-exit_vbat_worker:
+		sma6201_io_write(sma6201, SMA6201_IO_VBAT_WORKER,
+			SMA6201_0A_SPK_VOL, sma6201->init_vol + gain);
+	}
+out:
+	mutex_unlock(&sma6201->lock);
+}
 #endif
 
-	if (sma6201->check_thermal_vbat_enable) {
-		if (sma6201->check_thermal_vbat_period > 0)
-			queue_delayed_work(system_freezable_wq,
-				&sma6201->check_thermal_vbat_work,
-				sma6201->check_thermal_vbat_period * HZ);
-		else
-			queue_delayed_work(system_freezable_wq,
-				&sma6201->check_thermal_vbat_work,
-					CHECK_COMP_PERIOD_TIME * HZ);
+/* Zone temperature to the deci-degree of temp_match */
+static int sma6201_zone_to_deci(int temp)
+{
+#ifdef CONFIG_MACH_PIEZO
+	/* Converting xxxxx mC to xx.x C */
+	return temp / 100;
+#else
+	return temp * 10;
+#endif
+}
+
+/* Speaker gain cooling device : state i applies the gain of temp_match
+ * row i, init_vol + comp_gain unless the row is not activated. The
+ * platform binds it from its own cooling maps, or the driver binds it
+ * to the selected zone trips on the table breakpoints. While bound the
+ * governor throttles the gain instead of the periodic worker.
+ */
+static int sma6201_gain_cdev_get_max_state(struct thermal_cooling_device *cdev,
+		unsigned long *state)
+{
+	struct sma6201_priv *sma6201 = cdev->devdata;
+
+	*state = sma6201->num_of_temperature_matches - 1;
+
+	return 0;
+}
+
+static int sma6201_gain_cdev_get_cur_state(struct thermal_cooling_device *cdev,
+		unsigned long *state)
+{
+	struct sma6201_priv *sma6201 = cdev->devdata;
+
+	*state = READ_ONCE(sma6201->gain_state);
+
+	return 0;
+}
+
+/* Called under the zone lock, the gain is applied from temp_work */
+static int sma6201_gain_cdev_set_cur_state(struct thermal_cooling_device *cdev,
+		unsigned long state)
+{
+	struct sma6201_priv *sma6201 = cdev->devdata;
+
+	if (state >= sma6201->num_of_temperature_matches)
+		return -EINVAL;
+
+	WRITE_ONCE(sma6201->gain_state, state);
+	queue_work(system_freezable_wq, &sma6201->temp_work);
+
+	return 0;
+}
+
+static const struct thermal_cooling_device_ops sma6201_gain_cdev_ops = {
+	.get_max_state = sma6201_gain_cdev_get_max_state,
+	.get_cur_state = sma6201_gain_cdev_get_cur_state,
+	.set_cur_state = sma6201_gain_cdev_set_cur_state,
+};
+
+static void sma6201_temp_event_worker(struct work_struct *work)
+{
+	struct sma6201_priv *sma6201 =
+		container_of(work, struct sma6201_priv, temp_work);
+	int vbat_gain = 0;
+
+	mutex_lock(&sma6201->lock);
+
+	/* The cooling state applies whenever the gain device is bound,
+	 * the periodic worker is parked then. The battery level only
+	 * counts for music playback with the compensation enabled.
+	 */
+	if (sma6201_gain_cdev_bound(sma6201)) {
+		if (sma6201->check_thermal_vbat_enable &&
+			sma6201->voice_music_class_h_mode ==
+				SMA6201_CLASS_H_MUSIC_MODE)
+			vbat_gain = sma6201_vbat_gain(sma6201);
+
+		sma6201_temp_comp_apply(sma6201, SMA6201_IO_TEMP_WORKER,
+			READ_ONCE(sma6201->gain_state), vbat_gain);
 	}
+
 	mutex_unlock(&sma6201->lock);
 }
 
-static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
-		bool ocp_status)
+/* Unbind the trips of sma6201_bind_temp_trips only, the platform
+ * cooling maps keep their bindings. sma6201->lock held
+ */
+static void sma6201_unbind_temp_trips(struct sma6201_priv *sma6201,
+		struct thermal_zone_device *tz)
 {
-	unsigned int cur_vol;
-	int ret, i = 0;
-	struct outside_status fifo_buf_out = {0, };
-	int vbat_gain = 0, vbat_status;
+	int trip;
 
-	/* SPK OCP issued or monitoring function */
-	if (ocp_status) {
-		i = sma6201->threshold_level;
-		sma6201->temp_match[i].ocp_count++;
+	sma6201->temp_event = false;
 
-		if (i == 0) {
-			dev_info(sma6201->dev, "%s : OCP occured in normal temp\n",
-				__func__);
-		} else {
-			if (sma6201->enable_ocp_aging) {
-				/* Volume control (0dB/0x30) */
-				regmap_read(sma6201->regmap, SMA6201_0A_SPK_VOL,
-					&cur_vol);
+	if (sma6201->gain_cdev) {
+		for_each_set_bit(trip, &sma6201->temp_trips, BITS_PER_LONG)
+			thermal_zone_unbind_cooling_device(tz, trip,
+				sma6201->gain_cdev);
+	}
+	sma6201->temp_trips = 0;
+}
 
-				sma6201->temp_match[i].comp_gain++;
-				cur_vol = sma6201->init_vol +
-					sma6201->temp_match[i].comp_gain;
-				regmap_write(sma6201->regmap,
-					SMA6201_0A_SPK_VOL, cur_vol);
+/* Bind the gain device to the zone trips on the table breakpoints,
+ * sma6201->lock held. The driver can not add trips to a zone it does
+ * not own, the platform has to provide them in the DT zone. A partial
+ * binding would leave levels unreachable and is dropped again.
+ * temp_trips keeps the trips bound here, a binding that already
+ * exists is the platform's own and counts as reachable only.
+ */
+static void sma6201_bind_temp_trips(struct sma6201_priv *sma6201,
+		struct thermal_zone_device *tz)
+{
+	const struct thermal_trip *trips;
+	unsigned long bound = 0, rows = 0;
+	int ntrips, trip, i, ret;
+
+	sma6201->temp_trips = 0;
+	sma6201->temp_event = false;
+
+	if (!sma6201->gain_cdev)
+		return;
+
+	trips = of_thermal_get_trip_points(tz);
+	ntrips = min_t(int, of_thermal_get_ntrips(tz), BITS_PER_LONG);
+	if (!trips)
+		return;
+
+	for (trip = 0; trip < ntrips; trip++) {
+		/* The limit of row i - 1 is where row i starts */
+		for (i = 1; i < sma6201->num_of_temperature_matches; i++) {
+			if (sma6201_zone_to_deci(trips[trip].temperature) !=
+				sma6201->temp_match[i - 1].thermal_limit)
+				continue;
+
+			ret = thermal_zone_bind_cooling_device(tz, trip,
+				sma6201->gain_cdev, i, i,
+				THERMAL_WEIGHT_DEFAULT);
+			if (!ret)
+				bound |= BIT(trip);
+			if (!ret || ret == -EEXIST)
+				rows |= BIT(i);
+			break;
+		}
+	}
+
+	sma6201->temp_trips = bound;
+	sma6201->temp_event = (rows ==
+		GENMASK(sma6201->num_of_temperature_matches - 1, 1));
+	if (!sma6201->temp_event && bound)
+		sma6201_unbind_temp_trips(sma6201, tz);
+
+	dev_info(sma6201->dev, "%s : %s trips 0x%lx, %s\n", __func__,
+		sma6201_thermal_zone_name(sma6201), bound,
+		sma6201->temp_event ? "trip events" : "polling");
+}
+
+/* Whether a cooling map of a DT zone refers to the gain device,
+ * thermal_of_cooling_device_register binds it from there
+ */
+static bool sma6201_gain_cdev_mapped(struct device_node *np)
+{
+	struct device_node *zones, *zone, *maps, *map;
+	struct of_phandle_args args;
+	bool mapped = false;
+	int i;
+
+	zones = of_find_node_by_name(NULL, "thermal-zones");
+	if (!zones)
+		return false;
+
+	for_each_available_child_of_node(zones, zone) {
+		maps = of_get_child_by_name(zone, "cooling-maps");
+		if (!maps)
+			continue;
+
+		for_each_child_of_node(maps, map) {
+			for (i = 0; !of_parse_phandle_with_args(map,
+					"cooling-device", "#cooling-cells",
+					i, &args); i++) {
+				of_node_put(args.np);
+				if (args.np == np)
+					mapped = true;
 			}
 		}
-		/* Need to update compensation gain */
-		dev_info(sma6201->dev,
-			"%s :OCP occured in TEMP[%d] GAIN_C[%d] OCP_N[%d] HIT_N[%d] ACT[%d]\n",
-			__func__, sma6201->temp_match[i].thermal_limit,
-			sma6201->temp_match[i].comp_gain,
-			sma6201->temp_match[i].ocp_count,
-			sma6201->temp_match[i].hit_count,
-			sma6201->temp_match[i].activate);
+		of_node_put(maps);
 
-		return 0;
+		if (mapped) {
+			of_node_put(zone);
+			break;
+		}
 	}
+	of_node_put(zones);
 
-	if (!kfifo_is_empty(&sma6201->data_fifo)) {
-		ret = kfifo_out(&sma6201->data_fifo,
-			(unsigned char *)&fifo_buf_out,
-			sizeof(fifo_buf_out));
+	return mapped;
+}
 
-		dev_dbg(sma6201->dev, "%s :queue out\n", __func__);
+/* Bound by the platform cooling maps or on all table breakpoints
+ * by the driver, sma6201->lock held
+ */
+static bool sma6201_gain_cdev_bound(struct sma6201_priv *sma6201)
+{
+	if (!sma6201->gain_cdev)
+		return false;
 
-		if (ret != sizeof(fifo_buf_out))
-			return ret;
-#ifdef CONFIG_SMA6201_BATTERY_READING
-		dev_dbg(sma6201->dev,
-		"%s : id - [%d]  sense_temp - [%3d]  deg bat_vol - %d mV\n",
-		__func__, fifo_buf_out.id,
-		fifo_buf_out.thermal_deg,
-		fifo_buf_out.batt_voltage_mV/1000);
-#else
-		dev_dbg(sma6201->dev,
-		"%s : id - [%d]  sense_temp - [%3d]  deg\n",
-		__func__, fifo_buf_out.id,
-		fifo_buf_out.thermal_deg);
-#endif
+	return sma6201->gain_cdev_mapped || sma6201->temp_event;
+}
+
+/* Resolve the selected zone once, sma6201->lock held. Called when
+ * the compensation is enabled or thermal_sense_opt changes, the ticks
+ * only read the temperature of the kept zone. Thermal zones are not
+ * reference counted, the pointer is dropped together with the trip
+ * binding in sma6201_put_thermal_zone.
+ */
+static struct thermal_zone_device *sma6201_get_thermal_zone(
+		struct sma6201_priv *sma6201)
+{
+	const char *name = sma6201_thermal_zone_name(sma6201);
+	struct thermal_zone_device *tz;
+
+	if (sma6201->tz)
+		return sma6201->tz;
+
+	tz = thermal_zone_get_zone_by_name(name);
+	if (IS_ERR(tz)) {
+		dev_dbg(sma6201->dev, "%s : need to check thermal zone name:%s\n",
+			__func__, name);
+		return NULL;
+	}
+
+	sma6201->tz = tz;
+	sma6201_bind_temp_trips(sma6201, tz);
+
+	return tz;
+}
+
+/* Unbind from the selected zone, sma6201->lock held */
+static void sma6201_put_thermal_zone(struct sma6201_priv *sma6201)
+{
+	if (sma6201->tz)
+		sma6201_unbind_temp_trips(sma6201, sma6201->tz);
+	sma6201->temp_event = false;
+	sma6201->temp_trips = 0;
+	sma6201->tz = NULL;
+}
+
+/* Trip events stay on while the gain device is bound, otherwise the
+ * periodic worker polls the zone
+ */
+static bool sma6201_temp_events(struct sma6201_priv *sma6201)
+{
+	bool events;
+
+	mutex_lock(&sma6201->lock);
+	events = sma6201_gain_cdev_bound(sma6201);
+	mutex_unlock(&sma6201->lock);
+
+	return events;
+}
+
+/* sma6201->lock held or the worker stopped */
+static void sma6201_put_thermal_handles(struct sma6201_priv *sma6201)
+{
+	sma6201_put_thermal_zone(sma6201);
+
+	if (sma6201->batt_psy) {
+		power_supply_put(sma6201->batt_psy);
+		sma6201->batt_psy = NULL;
+	}
+}
+
+/* Next poll of the thermal worker in sec, sma6201->lock held. Far from
+ * the breakpoints of the current row the period stretches up to the
+ * max bound, closer it shrinks down to the min bound. A moving
+ * temperature is sampled at least twice before it can reach the
+ * nearer breakpoint. Without a reading the fixed period is used.
+ */
+static long sma6201_thermal_vbat_period(struct sma6201_priv *sma6201,
+		int deg, bool valid)
+{
+	long min_period = sma6201->check_thermal_vbat_period_min;
+	long max_period = sma6201->check_thermal_vbat_period_max;
+	unsigned int elapsed_ms;
+	long period;
+	int i, dist, delta;
+
+	if (!valid) {
+		sma6201->thermal_prev_jiffies = 0;
+		return sma6201->check_thermal_vbat_period > 0 ?
+			sma6201->check_thermal_vbat_period :
+			CHECK_COMP_PERIOD_TIME;
 	}
 
 	for (i = 0; i < sma6201->num_of_temperature_matches; i++) {
-		/* Check  matching temperature
-		 * compare current temp & table
-		 */
-		if ((fifo_buf_out.thermal_deg <
-			 sma6201->temp_match[i].thermal_limit)) {
-			dev_dbg(sma6201->dev,
-				"%s :Matched TEMP[%d] GAIN_C[%d] OCP_N[%d] HIT_N[%d] ACT[%d]\n",
-				__func__,
-				sma6201->temp_match[i].thermal_limit,
-				sma6201->temp_match[i].comp_gain,
-				sma6201->temp_match[i].ocp_count,
-				sma6201->temp_match[i].hit_count,
-				sma6201->temp_match[i].activate);
+		if (deg < sma6201->temp_match[i].thermal_limit)
 			break;
-		}
 	}
 
-	if (vbat_status != -1 &&
-		vbat_status < VBAT_TABLE_NUM) {
-		vbat_gain =
-			sma6201_vbat_gain_matches[vbat_status].comp_gain;
+	dist = CHECK_COMP_FAR_DEG;
+	if (i < sma6201->num_of_temperature_matches)
+		dist = min(dist, sma6201->temp_match[i].thermal_limit - deg);
+	if (i > 0)
+		dist = min(dist, deg - sma6201->temp_match[i - 1].thermal_limit);
+
+	period = min_period + (max_period - min_period) * dist /
+		CHECK_COMP_FAR_DEG;
+
+	delta = abs(deg - sma6201->thermal_prev_deg);
+	if (sma6201->thermal_prev_jiffies && delta) {
+		elapsed_ms = jiffies_to_msecs(jiffies -
+			sma6201->thermal_prev_jiffies);
+		period = min_t(long, period,
+			(long)dist * elapsed_ms / delta / 2 / MSEC_PER_SEC);
+	}
+
+	sma6201->thermal_prev_deg = deg;
+	sma6201->thermal_prev_jiffies = jiffies ? jiffies : 1;
+
+	return clamp(period, min_period, max_period);
+}
+
+static void sma6201_check_thermal_vbat_worker(struct work_struct *work)
+{
+	struct sma6201_priv *sma6201 =
+		container_of(work, struct sma6201_priv,
+			check_thermal_vbat_work.work);
+	struct outside_status fifo_buf_in = {0, };
+	struct thermal_zone_device *tz;
+	int ret = -ENODEV;
+
+	mutex_lock(&sma6201->lock);
+
+	sma6201->check_thermal_vbat_wakeups++;
+	tz = sma6201->tz;
+
+	if (tz) {
+		ret = thermal_zone_get_temp(tz, &fifo_buf_in.thermal_deg);
+		if (ret)
+			dev_dbg(sma6201->dev, "%s : thermal read fail %d\n",
+				__func__, ret);
+	}
+
+	fifo_buf_in.thermal_deg = sma6201_zone_to_deci(fifo_buf_in.thermal_deg);
+
+	fifo_buf_in.id = sma6201->fifo_count;
+
+	if (!kfifo_is_full(&sma6201->data_fifo)) {
+		kfifo_in(&sma6201->data_fifo,
+			(unsigned char *)&fifo_buf_in,
+			sizeof(fifo_buf_in));
+
+		sma6201->fifo_count++;
+		pr_debug("%s :queue in", __func__);
+	}
+
+	dev_dbg(sma6201->dev,
+	"%s : id - [%d]  sense_temp - [%3d]\n",
+	__func__, fifo_buf_in.id,
+	fifo_buf_in.thermal_deg);
+	sma6201_thermal_compensation(sma6201, SMA6201_IO_VBAT_WORKER, false);
+
+	/* Trip events take over once the gain device is bound */
+	if (sma6201->check_thermal_vbat_enable &&
+		!sma6201_gain_cdev_bound(sma6201)) {
+		sma6201->check_thermal_vbat_period_cur =
+			sma6201_thermal_vbat_period(sma6201,
+				fifo_buf_in.thermal_deg, !ret);
+		queue_delayed_work(system_freezable_wq,
+			&sma6201->check_thermal_vbat_work,
+			sma6201->check_thermal_vbat_period_cur * HZ);
+	} else {
+		sma6201->check_thermal_vbat_period_cur = 0;
 	}
+	mutex_unlock(&sma6201->lock);
+}
+
+/* Gain of temperature row i(num_of_temperature_matches : above the
+ * table) and of the battery level, sma6201->lock held
+ */
+static int sma6201_temp_comp_apply(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, int i, int vbat_gain)
+{
+	unsigned int cur_vol;
 
 	/* Updating the gain for battery level and temperature */
 	if (i == 0 || (sma6201->temp_match[i].activate == 0)) {
@@ -5396,13 +6921,13 @@ static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
 		if (vbat_gain > 0) {
 			/* Prefered battery level in normal temperature */
 			cur_vol = sma6201->init_vol + vbat_gain;
-			regmap_write(sma6201->regmap, SMA6201_0A_SPK_VOL,
+			sma6201_io_write(sma6201, site, SMA6201_0A_SPK_VOL,
 				cur_vol);
 			dev_info(sma6201->dev, "%s : low battery gain[%d] in normal temp\n",
 			__func__, cur_vol);
 		} else if (sma6201->threshold_level != i) {
 			/* Normal gain */
-			regmap_write(sma6201->regmap, SMA6201_0A_SPK_VOL,
+			sma6201_io_write(sma6201, site, SMA6201_0A_SPK_VOL,
 				sma6201->init_vol);
 		}
 	} else if (i < sma6201->num_of_temperature_matches) {
@@ -5418,13 +6943,13 @@ static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
 			if (vbat_gain > sma6201->temp_match[i].comp_gain) {
 				/* Case Battery gain comp */
 				cur_vol = sma6201->init_vol + vbat_gain;
-				regmap_write(sma6201->regmap,
+				sma6201_io_write(sma6201, site,
 					SMA6201_0A_SPK_VOL, cur_vol);
 			} else {
 				/* Temp comp */
 				cur_vol = sma6201->init_vol +
 					sma6201->temp_match[i].comp_gain;
-				regmap_write(sma6201->regmap,
+				sma6201_io_write(sma6201, site,
 					SMA6201_0A_SPK_VOL, cur_vol);
 			}
 			dev_info(sma6201->dev, "%s : cur temp[%d]  previous temp[%d] gain[%d]\n",
@@ -5438,7 +6963,7 @@ static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
 				"%s : cur temp[%d] - only vbat gain[%d] comp\n",
 				__func__, i, vbat_gain);
 			cur_vol = sma6201->init_vol + vbat_gain;
-			regmap_write(sma6201->regmap,
+			sma6201_io_write(sma6201, site,
 				SMA6201_0A_SPK_VOL, cur_vol);
 		}
 	}
@@ -5448,125 +6973,261 @@ static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
 	return 0;
 }
 
-#ifdef CONFIG_PM
-static int sma6201_suspend(struct snd_soc_component *component)
+static int sma6201_thermal_compensation(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, bool ocp_status)
 {
+	unsigned int cur_vol;
+	int ret, i = 0;
+	struct outside_status fifo_buf_out = {0, };
+	int vbat_gain;
 
-	dev_info(component->dev, "%s\n", __func__);
+	/* SPK OCP issued or monitoring function */
+	if (ocp_status) {
+		i = sma6201->threshold_level;
+		sma6201->temp_match[i].ocp_count++;
 
-	return 0;
+		if (i == 0) {
+			dev_info(sma6201->dev, "%s : OCP occured in normal temp\n",
+				__func__);
+		} else {
+			if (sma6201->enable_ocp_aging) {
+				/* Volume control (0dB/0x30) */
+				sma6201_io_read(sma6201, site,
+					SMA6201_0A_SPK_VOL, &cur_vol);
+
+				sma6201->temp_match[i].comp_gain++;
+				cur_vol = sma6201->init_vol +
+					sma6201->temp_match[i].comp_gain;
+				sma6201_io_write(sma6201, site,
+					SMA6201_0A_SPK_VOL, cur_vol);
+			}
+		}
+		/* Need to update compensation gain */
+		dev_info(sma6201->dev,
+			"%s :OCP occured in TEMP[%d] GAIN_C[%d] OCP_N[%d] HIT_N[%d] ACT[%d]\n",
+			__func__, sma6201->temp_match[i].thermal_limit,
+			sma6201->temp_match[i].comp_gain,
+			sma6201->temp_match[i].ocp_count,
+			sma6201->temp_match[i].hit_count,
+			sma6201->temp_match[i].activate);
+
+		return 0;
+	}
+
+	if (!kfifo_is_empty(&sma6201->data_fifo)) {
+		ret = kfifo_out(&sma6201->data_fifo,
+			(unsigned char *)&fifo_buf_out,
+			sizeof(fifo_buf_out));
+
+		dev_dbg(sma6201->dev, "%s :queue out\n", __func__);
+
+		if (ret != sizeof(fifo_buf_out))
+			return ret;
+		dev_dbg(sma6201->dev,
+		"%s : id - [%d]  sense_temp - [%3d]  deg bat_vol - %d mV\n",
+		__func__, fifo_buf_out.id,
+		fifo_buf_out.thermal_deg, sma6201->vbat_mV);
+	}
+
+	for (i = 0; i < sma6201->num_of_temperature_matches; i++) {
+		/* Check  matching temperature
+		 * compare current temp & table
+		 */
+		if ((fifo_buf_out.thermal_deg <
+			 sma6201->temp_match[i].thermal_limit)) {
+			dev_dbg(sma6201->dev,
+				"%s :Matched TEMP[%d] GAIN_C[%d] OCP_N[%d] HIT_N[%d] ACT[%d]\n",
+				__func__,
+				sma6201->temp_match[i].thermal_limit,
+				sma6201->temp_match[i].comp_gain,
+				sma6201->temp_match[i].ocp_count,
+				sma6201->temp_match[i].hit_count,
+				sma6201->temp_match[i].activate);
+			break;
+		}
+	}
+
+	vbat_gain = sma6201_vbat_gain(sma6201);
+
+	return sma6201_temp_comp_apply(sma6201, site, i, vbat_gain);
 }
 
-static int sma6201_resume(struct snd_soc_component *component)
+/* Init image : one value per register, SMA6201_IMG_UNSET if not written */
+#define SMA6201_INIT_IMAGE_SIZE	(SMA6201_EQ_BANK_MAX + 1)
+#define SMA6201_IMG_UNSET	(-1)
+
+static void sma6201_img_write(int *img, unsigned int reg, unsigned int val)
 {
+	img[reg] = val & 0xFF;
+}
 
-	dev_info(component->dev, "%s\n", __func__);
+static void sma6201_img_update(struct sma6201_priv *sma6201, int *img,
+		unsigned int reg, unsigned int mask, unsigned int val)
+{
+	unsigned int orig = 0;
 
-	return 0;
+	/* Start from the register cache(default) value, no I2C access */
+	if (img[reg] == SMA6201_IMG_UNSET) {
+		sma6201_io_read(sma6201, SMA6201_IO_PROBE, reg, &orig);
+		img[reg] = orig;
+	}
+	img[reg] = (img[reg] & ~mask) | (val & mask);
 }
-#else
-#define sma6201_suspend NULL
-#define sma6201_resume NULL
-#endif
 
-static int sma6201_reset(struct snd_soc_component *component)
+static void sma6201_img_load_dt(struct sma6201_priv *sma6201, int *img,
+		const uint32_t *reg_array, int len, unsigned int bank_base)
 {
-	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
 	struct reg_default *reg_val;
-	int cnt, ret;
-	unsigned int status;
-	int eq_len = sma6201->eq_reg_array_len / sizeof(uint32_t);
-	int bo_len = sma6201->bo_reg_array_len / sizeof(uint32_t);
+	unsigned int reg;
+	int cnt;
 
-	dev_info(component->dev, "%s\n", __func__);
+	if (reg_array == NULL)
+		return;
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FF_VERSION, &status);
+	for (cnt = 0; cnt + 1 < len; cnt += 2) {
+		reg_val = (struct reg_default *)&reg_array[cnt];
+		reg = be32_to_cpu(reg_val->reg);
+		if (bank_base)
+			reg = sma6201_eq_bank_reg(bank_base, reg);
+
+		if (reg >= SMA6201_INIT_IMAGE_SIZE ||
+			!sma6201_writeable_register(sma6201->dev, reg)) {
+			dev_err(sma6201->dev, "%s : invalid register 0x%02x\n",
+					__func__, reg);
+			continue;
+		}
+		dev_dbg(sma6201->dev, "%s : reg_write [0x%02x, 0x%02x]",
+				__func__, reg, be32_to_cpu(reg_val->def));
+		sma6201_img_write(img, reg, be32_to_cpu(reg_val->def));
+	}
+}
 
-	if (ret != 0)
-		dev_err(sma6201->dev,
-			"failed to read SMA6201_FF_VERSION : %d\n", ret);
-	else
-		sma6201->rev_num = status & REV_NUM_STATUS;
+/* The register cache starts from sma6201_reg_def, but the chip keeps
+ * its registers over a module reload or a warm reboot and has no soft
+ * reset. Write every cached default to the chip, bypassing the cache,
+ * so both agree before the cache is trusted. SYSTEM_CTRL goes first
+ * and powers the amp down.
+ */
+static int sma6201_sync_reg_defaults(struct sma6201_priv *sma6201)
+{
+	struct reg_sequence *seq;
+	int i, n = 0, ret;
 
-	dev_info(component->dev, "SMA6201 chip revision ID - %d\n",
-			sma6201->rev_num);
+	seq = kmalloc_array(ARRAY_SIZE(sma6201_reg_def), sizeof(*seq),
+			GFP_KERNEL);
+	if (!seq)
+		return -ENOMEM;
+
+	for (i = 0; i < ARRAY_SIZE(sma6201_reg_def); i++) {
+		if (!sma6201_cacheable_register(sma6201->dev,
+				sma6201_reg_def[i].reg))
+			continue;
+		seq[n].reg = sma6201_reg_def[i].reg;
+		seq[n].def = sma6201_reg_def[i].def;
+		seq[n].delay_us = 0;
+		n++;
+	}
+
+	ret = sma6201_io_multi_reg_write(sma6201, SMA6201_IO_PROBE,
+			seq, n, true);
+	kfree(seq);
+
+	return ret;
+}
+
+/* Build the chip init image for the detected revision once at probe.
+ * The image is kept as a sorted reg_sequence and the contiguous runs
+ * in it are written as auto-increment bulk transfers by reset.
+ */
+static int sma6201_build_init_image(struct sma6201_priv *sma6201)
+{
+	struct sma6201_init_block *blk;
+	int eq_len = sma6201->eq_reg_array_len / sizeof(uint32_t);
+	int bo_len = sma6201->bo_reg_array_len / sizeof(uint32_t);
+	int *img;
+	int reg, num, n = 0, num_blocks = 0;
+
+	img = kmalloc_array(SMA6201_INIT_IMAGE_SIZE, sizeof(int), GFP_KERNEL);
+	if (!img)
+		return -ENOMEM;
+
+	for (reg = 0; reg < SMA6201_INIT_IMAGE_SIZE; reg++)
+		img[reg] = SMA6201_IMG_UNSET;
 
 	/* External clock 24.576MHz */
-	regmap_write(sma6201->regmap, SMA6201_00_SYSTEM_CTRL, 0x80);
-	/* Volume control (0dB/0x30) */
-	regmap_write(sma6201->regmap, SMA6201_0A_SPK_VOL, sma6201->init_vol);
+	sma6201_img_write(img, SMA6201_00_SYSTEM_CTRL, 0x80);
 	/* VOL_SLOPE - Fast Volume Slope,
 	 * MUTE_SLOPE - Fast Mute Slope, SPK_MUTE - muted
 	 */
-	regmap_write(sma6201->regmap, SMA6201_0E_MUTE_VOL_CTRL,	0xFF);
+	sma6201_img_write(img, SMA6201_0E_MUTE_VOL_CTRL,	0xFF);
 
 	/* Bass Off & EQ Enable
 	 * MONO_MIX Off(TW) for SPK Signal Path
 	 */
-	regmap_write(sma6201->regmap, SMA6201_11_SYSTEM_CTRL2, 0xA0);
+	sma6201_img_write(img, SMA6201_11_SYSTEM_CTRL2, 0xA0);
 
 	if (sma6201->stereo_two_chip == true) {
 		/* MONO MIX Off */
-		regmap_update_bits(sma6201->regmap,
+		sma6201_img_update(sma6201, img,
 		SMA6201_11_SYSTEM_CTRL2, MONOMIX_MASK, MONOMIX_OFF);
 	} else {
 		/* MONO MIX ON */
-		regmap_update_bits(sma6201->regmap,
+		sma6201_img_update(sma6201, img,
 		SMA6201_11_SYSTEM_CTRL2, MONOMIX_MASK, MONOMIX_ON);
 	}
 
 	/* Stereo idle noise improvement, FDPEC Gain - 4,
 	 * HDC OPAMP Current - 80uA
 	 */
-	regmap_write(sma6201->regmap, SMA6201_13_FDPEC_CTRL1, 0x29);
+	sma6201_img_write(img, SMA6201_13_FDPEC_CTRL1, 0x29);
 
 	if (sma6201->rev_num == REV_NUM_REV0) {
 		/* Delay control between OUTA and
 		 * OUTB with main clock duty cycle
 		 */
-		regmap_write(sma6201->regmap, SMA6201_14_MODULATOR, 0x61);
+		sma6201_img_write(img, SMA6201_14_MODULATOR, 0x61);
 	} else {
 		/* Delay control between OUTA and
 		 * OUTB with main clock duty cycle
 		 */
-		regmap_write(sma6201->regmap, SMA6201_14_MODULATOR, 0x0D);
+		sma6201_img_write(img, SMA6201_14_MODULATOR, 0x0D);
 	}
 
 	/* HPF Frequency - 97 Hz */
-	regmap_write(sma6201->regmap, SMA6201_15_BASS_SPK1,	0x03);
-	regmap_write(sma6201->regmap, SMA6201_16_BASS_SPK2,	0x05);
-	regmap_write(sma6201->regmap, SMA6201_17_BASS_SPK3,	0x05);
-	regmap_write(sma6201->regmap, SMA6201_18_BASS_SPK4,	0x0E);
-	regmap_write(sma6201->regmap, SMA6201_19_BASS_SPK5,	0x21);
-	regmap_write(sma6201->regmap, SMA6201_1A_BASS_SPK6,	0x0B);
-	regmap_write(sma6201->regmap, SMA6201_1B_BASS_SPK7,	0x06);
-	regmap_write(sma6201->regmap, SMA6201_21_DGC,		0x96);
+	sma6201_img_write(img, SMA6201_15_BASS_SPK1,	0x03);
+	sma6201_img_write(img, SMA6201_16_BASS_SPK2,	0x05);
+	sma6201_img_write(img, SMA6201_17_BASS_SPK3,	0x05);
+	sma6201_img_write(img, SMA6201_18_BASS_SPK4,	0x0E);
+	sma6201_img_write(img, SMA6201_19_BASS_SPK5,	0x21);
+	sma6201_img_write(img, SMA6201_1A_BASS_SPK6,	0x0B);
+	sma6201_img_write(img, SMA6201_1B_BASS_SPK7,	0x06);
+	sma6201_img_write(img, SMA6201_21_DGC,		0x96);
 
 	if (sma6201->rev_num == REV_NUM_REV0) {
 		/* Prescaler Enable, -0.25dB Pre Gain */
-		regmap_write(sma6201->regmap, SMA6201_22_PRESCALER, 0x2C);
+		sma6201_img_write(img, SMA6201_22_PRESCALER, 0x2C);
 	} else {
 		/* Prescaler Bypass */
-		regmap_write(sma6201->regmap, SMA6201_22_PRESCALER, 0x2D);
+		sma6201_img_write(img, SMA6201_22_PRESCALER, 0x2D);
 	}
 
-	regmap_write(sma6201->regmap, SMA6201_23_COMP_LIM1, 0x1F);
-	regmap_write(sma6201->regmap, SMA6201_24_COMP_LIM2, 0x02);
-	regmap_write(sma6201->regmap, SMA6201_25_COMP_LIM3, 0x09);
-	regmap_write(sma6201->regmap, SMA6201_26_COMP_LIM4, 0xFF);
+	sma6201_img_write(img, SMA6201_23_COMP_LIM1, 0x1F);
+	sma6201_img_write(img, SMA6201_24_COMP_LIM2, 0x02);
+	sma6201_img_write(img, SMA6201_25_COMP_LIM3, 0x09);
+	sma6201_img_write(img, SMA6201_26_COMP_LIM4, 0xFF);
 
 	/* Disable Battery Overvoltage, Disable Return Current Control */
-	regmap_write(sma6201->regmap, SMA6201_27_RET_CUR_CTRL, 0x00);
+	sma6201_img_write(img, SMA6201_27_RET_CUR_CTRL, 0x00);
 
-	regmap_write(sma6201->regmap, SMA6201_2B_EQ_MODE,		0x17);
-	regmap_write(sma6201->regmap, SMA6201_2C_EQBAND1_BYP,	0x0C);
-	regmap_write(sma6201->regmap, SMA6201_2D_EQBAND2_BYP,	0x0C);
-	regmap_write(sma6201->regmap, SMA6201_2E_EQBAND3_BYP,	0x0C);
-	regmap_write(sma6201->regmap, SMA6201_2F_EQBAND4_BYP,	0x0C);
-	regmap_write(sma6201->regmap, SMA6201_30_EQBAND5_BYP,	0x0C);
+	sma6201_img_write(img, SMA6201_2B_EQ_MODE,		0x17);
+	sma6201_img_write(img, SMA6201_2C_EQBAND1_BYP,	0x0C);
+	sma6201_img_write(img, SMA6201_2D_EQBAND2_BYP,	0x0C);
+	sma6201_img_write(img, SMA6201_2E_EQBAND3_BYP,	0x0C);
+	sma6201_img_write(img, SMA6201_2F_EQBAND4_BYP,	0x0C);
+	sma6201_img_write(img, SMA6201_30_EQBAND5_BYP,	0x0C);
 
 	/* PWM Slope control, PWM Dead time control */
-	regmap_write(sma6201->regmap, SMA6201_37_SLOPE_CTRL, 0x05);
+	sma6201_img_write(img, SMA6201_37_SLOPE_CTRL, 0x05);
 
 	if (sma6201->rev_num == REV_NUM_REV0) {
 		/* Feedback gain trimming - No trimming,
@@ -5575,21 +7236,21 @@ static int sma6201_reset(struct snd_soc_component *component)
 		 * PWM frequency - 740kHz,
 		 * Differential OPAMP bias current - 80uA
 		 */
-		regmap_write(sma6201->regmap, SMA6201_92_FDPEC_CTRL2, 0x23);
+		sma6201_img_write(img, SMA6201_92_FDPEC_CTRL2, 0x23);
 		/* Trimming of VBG reference - 1.2V,
 		 * Trimming of boost output voltage - 18.0V
 		 */
-		regmap_write(sma6201->regmap, SMA6201_93_BOOST_CTRL0, 0x8C);
+		sma6201_img_write(img, SMA6201_93_BOOST_CTRL0, 0x8C);
 		/* Trimming of ramp compensation I-gain - 50pF,
 		 * Trimming of switching frequency - 3.34MHz
 		 * Trimming of ramp compensation - 7.37A / us
 		 */
-		regmap_write(sma6201->regmap, SMA6201_94_BOOST_CTRL1, 0x9B);
+		sma6201_img_write(img, SMA6201_94_BOOST_CTRL1, 0x9B);
 		/* Trimming of over current limit - 3.1A,
 		 * Trimming of ramp compensation - P-gain:3.5Mohm,
 		 * Type II I-gain:0.7pF
 		 */
-		regmap_write(sma6201->regmap, SMA6201_95_BOOST_CTRL2, 0x44);
+		sma6201_img_write(img, SMA6201_95_BOOST_CTRL2, 0x44);
 	} else {
 		/* Feedback gain trimming - No trimming,
 		 * Recovery Current Control Mode - Enhanced mode,
@@ -5597,193 +7258,327 @@ static int sma6201_reset(struct snd_soc_component *component)
 		 * PWM frequency - 740kHz,
 		 * Differential OPAMP bias current - 80uA
 		 */
-		regmap_write(sma6201->regmap, SMA6201_92_FDPEC_CTRL2, 0x02);
+		sma6201_img_write(img, SMA6201_92_FDPEC_CTRL2, 0x02);
 		/* Trimming of VBG reference - 1.2V,
 		 * Trimming of boost output voltage - 19.0V
 		 */
-		regmap_write(sma6201->regmap, SMA6201_93_BOOST_CTRL0, 0x8D);
+		sma6201_img_write(img, SMA6201_93_BOOST_CTRL0, 0x8D);
 		/* Trimming of ramp compensation I-gain - 50pF,
 		 * Trimming of switching frequency - 3.34MHz
 		 * Trimming of ramp compensation - 9.22A / us
 		 */
-		regmap_write(sma6201->regmap, SMA6201_94_BOOST_CTRL1, 0x9D);
+		sma6201_img_write(img, SMA6201_94_BOOST_CTRL1, 0x9D);
 		/* Trimming of over current limit - 3.1A,
 		 * Trimming of ramp compensation - P-gain:3.0Mohm,
 		 * Type II I-gain:2.0pF
 		 */
-		regmap_write(sma6201->regmap, SMA6201_95_BOOST_CTRL2, 0x4B);
+		sma6201_img_write(img, SMA6201_95_BOOST_CTRL2, 0x4B);
 	}
 
 	/* Trimming of driver deadtime - 10.4ns,
 	 * Trimming of boost OCP - pMOS OCP enable, nMOS OCP enable,
 	 * Trimming of switching slew - 3ns
 	 */
-	regmap_write(sma6201->regmap, SMA6201_96_BOOST_CTRL3, 0x3E);
+	sma6201_img_write(img, SMA6201_96_BOOST_CTRL3, 0x3E);
 
 	if (sma6201->rev_num == REV_NUM_REV0) {
 		/* Trimming of boost level reference
 		 * - 0.825,0.70,0.575,0.50,0.40,0.28
 		 * Trimming of minimum on-time - 59ns
 		 */
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_97_BOOST_CTRL4, 0xA4);
 	} else {
 		/* Trimming of boost level reference
 		 * - 0.875,0.700,0.525,0.40,0.32,0.28
 		 * Trimming of minimum on-time - 68ns
 		 */
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_97_BOOST_CTRL4, 0x41);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_38_DIS_CLASSH_LVL12, 0xC8);
 	}
 
 	/* PLL Lock enable, External clock  operation */
-	regmap_write(sma6201->regmap, SMA6201_A2_TOP_MAN1, 0x69);
+	sma6201_img_write(img, SMA6201_A2_TOP_MAN1, 0x69);
 	/* External clock monitoring mode */
-	regmap_write(sma6201->regmap, SMA6201_A7_TOP_MAN3, 0x20);
+	sma6201_img_write(img, SMA6201_A7_TOP_MAN3, 0x20);
 
 	if (sma6201->rev_num == REV_NUM_REV0) {
 		/* Apply -1.0dB fine volume to prevent SPK OCP */
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_A9_TONE_FINE_VOL, 0x87);
 	} else {
 		/* Apply -1.25dB fine volume to prevent SPK OCP */
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_A9_TONE_FINE_VOL, 0x97);
 	}
 	/* Turn off the tone generator by default */
-	regmap_update_bits(sma6201->regmap, SMA6201_A9_TONE_FINE_VOL,
+	sma6201_img_update(sma6201, img, SMA6201_A9_TONE_FINE_VOL,
 				TONE_VOL_MASK, TONE_VOL_OFF);
-	regmap_update_bits(sma6201->regmap, SMA6201_A8_TONE_GENERATOR,
+	sma6201_img_update(sma6201, img, SMA6201_A8_TONE_GENERATOR,
 				TONE_ON_MASK, TONE_OFF);
 
 	/* Speaker OCP level - 3.7A */
-	regmap_write(sma6201->regmap, SMA6201_AD_SPK_OCP_LVL, 0x46);
+	sma6201_img_write(img, SMA6201_AD_SPK_OCP_LVL, 0x46);
 	/* High-Z for IRQ pin (IRQ skip mode) */
-	regmap_write(sma6201->regmap, SMA6201_AE_TOP_MAN4, 0x40);
+	sma6201_img_write(img, SMA6201_AE_TOP_MAN4, 0x40);
 	/* VIN sensing Power down, VIN cut off freq - 34kHz,
 	 * SAR clock freq - 3.072MHz
 	 */
-	regmap_write(sma6201->regmap, SMA6201_AF_VIN_SENSING, 0x01);
+	sma6201_img_write(img, SMA6201_AF_VIN_SENSING, 0x01);
 
 	/* Brown Out Protection Normal operation */
-	regmap_write(sma6201->regmap, SMA6201_B0_BROWN_OUT_P0, 0x85);
+	sma6201_img_write(img, SMA6201_B0_BROWN_OUT_P0, 0x85);
 
 	if (sma6201->rev_num == REV_NUM_REV0) {
 		/* Class-H Initial Setting */
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x4C);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x3B);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_28_CLASS_H_CTRL_LVL3, 0x5A);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_29_CLASS_H_CTRL_LVL4, 0x89);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_2A_CLASS_H_CTRL_LVL5, 0x68);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_90_CLASS_H_CTRL_LVL6, 0x87);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_91_CLASS_H_CTRL_LVL7, 0xB6);
 	} else {
 		/* Class-H Initial Setting */
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_0D_CLASS_H_CTRL_LVL1, 0x9C);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_0F_CLASS_H_CTRL_LVL2, 0x6B);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_28_CLASS_H_CTRL_LVL3, 0x7A);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_29_CLASS_H_CTRL_LVL4, 0xA9);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_2A_CLASS_H_CTRL_LVL5, 0x68);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_90_CLASS_H_CTRL_LVL6, 0x97);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_91_CLASS_H_CTRL_LVL7, 0xC6);
-		regmap_write(sma6201->regmap,
+		sma6201_img_write(img,
 			SMA6201_38_DIS_CLASSH_LVL12, 0xC8);
 	}
 
 	if (sma6201->src_bypass == true) {
-		regmap_update_bits(sma6201->regmap, SMA6201_03_INPUT1_CTRL3,
+		sma6201_img_update(sma6201, img, SMA6201_03_INPUT1_CTRL3,
 			BP_SRC_MASK, BP_SRC_BYPASS);
 
 		if (sma6201->stereo_two_chip == false)
-			regmap_update_bits(sma6201->regmap, SMA6201_A3_TOP_MAN2,
+			sma6201_img_update(sma6201, img, SMA6201_A3_TOP_MAN2,
 				BP_SRC_MIX_MASK, BP_SRC_MIX_MONO);
 		else
-			regmap_update_bits(sma6201->regmap, SMA6201_A3_TOP_MAN2,
+			sma6201_img_update(sma6201, img, SMA6201_A3_TOP_MAN2,
 				BP_SRC_MIX_MASK, BP_SRC_MIX_NORMAL);
 	} else {
-		regmap_update_bits(sma6201->regmap, SMA6201_03_INPUT1_CTRL3,
+		sma6201_img_update(sma6201, img, SMA6201_03_INPUT1_CTRL3,
 			BP_SRC_MASK, BP_SRC_NORMAL);
 	}
 
 	if (sma6201->sys_clk_id == SMA6201_EXTERNAL_CLOCK_19_2
 		|| sma6201->sys_clk_id == SMA6201_PLL_CLKIN_MCLK) {
-		regmap_update_bits(sma6201->regmap, SMA6201_00_SYSTEM_CTRL,
+		sma6201_img_update(sma6201, img, SMA6201_00_SYSTEM_CTRL,
 			CLKSYSTEM_MASK, EXT_19_2);
 
-		regmap_update_bits(sma6201->regmap, SMA6201_03_INPUT1_CTRL3,
+		sma6201_img_update(sma6201, img, SMA6201_03_INPUT1_CTRL3,
 			BP_SRC_MASK, BP_SRC_NORMAL);
 	}
 
-	dev_info(component->dev,
-		"%s init_vol is 0x%x\n", __func__, sma6201->init_vol);
-	/* EQ1 register value writing
+	/* EQ1, EQ2, BrownOut Protection register value
 	 * if register value is available from DT
 	 */
-	if (sma6201->eq1_reg_array != NULL) {
-		for (cnt = 0; cnt < eq_len; cnt += 2) {
-			reg_val = (struct reg_default *)
-				&sma6201->eq1_reg_array[cnt];
-			dev_dbg(component->dev, "%s : eq1 reg_write [0x%02x, 0x%02x]",
-					__func__, be32_to_cpu(reg_val->reg),
-						be32_to_cpu(reg_val->def));
-			regmap_write(sma6201->regmap, be32_to_cpu(reg_val->reg),
-					be32_to_cpu(reg_val->def));
+	sma6201_img_load_dt(sma6201, img, sma6201->eq1_reg_array,
+			eq_len, SMA6201_EQ1_BANK_BASE);
+	sma6201_img_load_dt(sma6201, img, sma6201->eq2_reg_array,
+			eq_len, SMA6201_EQ2_BANK_BASE);
+	sma6201_img_load_dt(sma6201, img, sma6201->bo_reg_array,
+			bo_len, 0);
+
+	for (reg = 0; reg < SMA6201_INIT_IMAGE_SIZE; reg++) {
+		if (img[reg] == SMA6201_IMG_UNSET)
+			continue;
+		if (n == 0 || img[reg - 1] == SMA6201_IMG_UNSET ||
+			reg == SMA6201_EQ1_BANK_BASE)
+			num_blocks++;
+		n++;
+	}
+
+	sma6201->init_seq = devm_kcalloc(sma6201->dev, n,
+			sizeof(struct reg_sequence), GFP_KERNEL);
+	sma6201->init_val = devm_kzalloc(sma6201->dev, n, GFP_KERNEL);
+	sma6201->init_blocks = devm_kcalloc(sma6201->dev, num_blocks,
+			sizeof(struct sma6201_init_block), GFP_KERNEL);
+	if (!sma6201->init_seq || !sma6201->init_val ||
+		!sma6201->init_blocks) {
+		kfree(img);
+		return -ENOMEM;
+	}
+
+	num = 0;
+	blk = NULL;
+	for (reg = 0; reg < SMA6201_INIT_IMAGE_SIZE; reg++) {
+		if (img[reg] == SMA6201_IMG_UNSET)
+			continue;
+		/* The EQ banks start a block of their own */
+		if (num == 0 || img[reg - 1] == SMA6201_IMG_UNSET ||
+			reg == SMA6201_EQ1_BANK_BASE) {
+			blk = blk ? blk + 1 : sma6201->init_blocks;
+			blk->idx = num;
+			blk->len = 0;
 		}
+		sma6201->init_seq[num].reg = reg;
+		sma6201->init_seq[num].def = img[reg];
+		sma6201->init_val[num] = img[reg];
+		blk->len++;
+		num++;
 	}
-	/* EQ2 register value writing
-	 * if register value is available from DT
-	 */
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ2_BANK_SEL);
-	if (sma6201->eq2_reg_array != NULL) {
-		for (cnt = 0; cnt < eq_len; cnt += 2) {
-			reg_val = (struct reg_default *)
-				&sma6201->eq2_reg_array[cnt];
-			dev_dbg(component->dev, "%s : eq2 reg_write [0x%02x, 0x%02x]",
-					__func__, be32_to_cpu(reg_val->reg),
-						be32_to_cpu(reg_val->def));
-			regmap_write(sma6201->regmap, be32_to_cpu(reg_val->reg),
-					be32_to_cpu(reg_val->def));
+	sma6201->init_seq_len = n;
+	sma6201->num_init_blocks = num_blocks;
+
+	kfree(img);
+
+	dev_info(sma6201->dev, "%s : rev %d, %d registers in %d blocks\n",
+			__func__, sma6201->rev_num, n, num_blocks);
+
+	return 0;
+}
+
+/* EQ1/EQ2 coefficients, uploaded by sma6201_tuning_worker */
+static bool sma6201_init_block_tuning(struct sma6201_priv *sma6201,
+		struct sma6201_init_block *blk)
+{
+	return sma6201->init_seq[blk->idx].reg >= SMA6201_EQ1_BANK_BASE;
+}
+
+/* Write the init image in ascending register order : contiguous runs
+ * as bulk transfers, isolated registers gathered into multi_reg_write.
+ * tuning selects the EQ bank blocks, otherwise the main register map.
+ */
+static int sma6201_apply_init_image(struct sma6201_priv *sma6201,
+		enum sma6201_io_site site, bool tuning)
+{
+	struct sma6201_init_block *blk = sma6201->init_blocks;
+	int i, j, ret;
+
+	for (i = 0; i < sma6201->num_init_blocks; i = j) {
+		if (sma6201_init_block_tuning(sma6201, &blk[i]) != tuning) {
+			j = i + 1;
+			continue;
 		}
+		if (blk[i].len > 1) {
+			ret = sma6201_io_raw_write(sma6201, site,
+					sma6201->init_seq[blk[i].idx].reg,
+					&sma6201->init_val[blk[i].idx],
+					blk[i].len);
+			j = i + 1;
+		} else {
+			for (j = i; j < sma6201->num_init_blocks
+				&& blk[j].len == 1
+				&& sma6201_init_block_tuning(sma6201, &blk[j])
+					== tuning; j++)
+				;
+			ret = sma6201_io_multi_reg_write(sma6201, site,
+					&sma6201->init_seq[blk[i].idx], j - i,
+					false);
+		}
+		if (ret)
+			return ret;
 	}
-	regmap_update_bits(sma6201->regmap, SMA6201_2B_EQ_MODE,
-			EQ_BANK_SEL_MASK, EQ1_BANK_SEL);
-	/* BrownOut Protection register value writing
-	 * if register value is available from DT
+
+	return 0;
+}
+
+/* EQ coefficient upload, queued from the i2c probe so that it runs
+ * until the sound card binds the component. The component probe waits
+ * for it before any control exists, nothing else writes the EQ banks.
+ */
+static void sma6201_tuning_worker(struct work_struct *work)
+{
+	struct sma6201_priv *sma6201 =
+		container_of(work, struct sma6201_priv, tuning_work);
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = sma6201_apply_init_image(sma6201, SMA6201_IO_TUNING, true);
+	if (ret)
+		dev_err(sma6201->dev, "failed to write EQ tuning : %d\n",
+				ret);
+	sma6201->tuning_applied = true;
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_TUNING, start);
+
+	complete_all(&sma6201->tuning_done);
+}
+
+static int sma6201_wait_tuning_done(struct sma6201_priv *sma6201)
+{
+	if (!wait_for_completion_timeout(&sma6201->tuning_done,
+			msecs_to_jiffies(TUNING_DONE_TIMEOUT))) {
+		dev_err(sma6201->dev, "%s : EQ tuning timeout\n", __func__);
+		return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
+/* Writes the main register map, which keeps the amp powered down
+ * and muted, next to the EQ coefficients of sma6201_tuning_worker.
+ * Called with tuning_done complete.
+ */
+static int sma6201_reset(struct snd_soc_component *component)
+{
+	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
+	ktime_t start = ktime_get();
+	int ret;
+
+	dev_info(component->dev, "%s\n", __func__);
+
+	dev_info(component->dev, "SMA6201 chip revision ID - %d\n",
+			sma6201->rev_num);
+
+	sma6201_flush_deferred_writes(sma6201, SMA6201_IO_PROBE);
+
+	/* A rebind gets the EQ image again, the upload of the i2c
+	 * probe went to the first bind only
 	 */
-	if (sma6201->bo_reg_array != NULL) {
-		for (cnt = 0; cnt < bo_len; cnt += 2) {
-			reg_val = (struct reg_default *)
-				&sma6201->bo_reg_array[cnt];
-			dev_dbg(component->dev, "%s reg_write [0x%02x, 0x%02x]",
-					__func__, be32_to_cpu(reg_val->reg),
-						be32_to_cpu(reg_val->def));
-			regmap_write(sma6201->regmap, be32_to_cpu(reg_val->reg),
-					be32_to_cpu(reg_val->def));
-		}
+	if (!sma6201->tuning_applied) {
+		ret = sma6201_apply_init_image(sma6201, SMA6201_IO_PROBE, true);
+		if (ret)
+			dev_err(component->dev,
+				"failed to write EQ tuning : %d\n", ret);
 	}
+	sma6201->tuning_applied = false;
+
+	ret = sma6201_apply_init_image(sma6201, SMA6201_IO_PROBE, false);
+	sma6201_shadow_invalidate(sma6201);
+	if (ret)
+		dev_err(component->dev, "failed to write init image : %d\n",
+				ret);
+
+	/* Volume control (0dB/0x30) */
+	sma6201_io_write(sma6201, SMA6201_IO_PROBE, SMA6201_0A_SPK_VOL,
+			sma6201->init_vol);
+
+	dev_info(component->dev,
+		"%s init_vol is 0x%x\n", __func__, sma6201->init_vol);
 
 	/* Ready to start amp, if need, add amp on/off mix */
 	sma6201->voice_music_class_h_mode = SMA6201_CLASS_H_MODE_OFF;
 	sma6201->ocp_count = 0;
 
-	return 0;
+	/* AMP is powered down until startup */
+	sma6201_defer_writes(sma6201, SMA6201_IO_PROBE);
+
+	sma6201_phase_end(sma6201, SMA6201_PHASE_RESET, start);
+
+	return ret;
 }
 
 static ssize_t check_thermal_vbat_period_show(struct device *dev,
@@ -5812,7 +7607,108 @@ static ssize_t check_thermal_vbat_period_store(struct device *dev,
 	return (ssize_t)count;
 }
 
-static DEVICE_ATTR_RW(check_thermal_vbat_period);
+static DEVICE_ATTR_RW(check_thermal_vbat_period);
+
+static ssize_t check_thermal_vbat_period_min_show(struct device *dev,
+	struct device_attribute *devattr, char *buf)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int rc;
+
+	rc = (int)snprintf(buf, PAGE_SIZE,
+			"%ld\n", sma6201->check_thermal_vbat_period_min);
+
+	return (ssize_t)rc;
+}
+
+static ssize_t check_thermal_vbat_period_min_store(struct device *dev,
+	struct device_attribute *devattr, const char *buf, size_t count)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	long value;
+	int ret;
+
+	ret = kstrtol(buf, 10, &value);
+
+	if (ret || value < 1)
+		return -EINVAL;
+
+	mutex_lock(&sma6201->lock);
+	if (value > sma6201->check_thermal_vbat_period_max)
+		ret = -EINVAL;
+	else
+		sma6201->check_thermal_vbat_period_min = value;
+	mutex_unlock(&sma6201->lock);
+
+	return ret ? ret : (ssize_t)count;
+}
+
+static DEVICE_ATTR_RW(check_thermal_vbat_period_min);
+
+static ssize_t check_thermal_vbat_period_max_show(struct device *dev,
+	struct device_attribute *devattr, char *buf)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int rc;
+
+	rc = (int)snprintf(buf, PAGE_SIZE,
+			"%ld\n", sma6201->check_thermal_vbat_period_max);
+
+	return (ssize_t)rc;
+}
+
+static ssize_t check_thermal_vbat_period_max_store(struct device *dev,
+	struct device_attribute *devattr, const char *buf, size_t count)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	long value;
+	int ret;
+
+	ret = kstrtol(buf, 10, &value);
+
+	if (ret)
+		return -EINVAL;
+
+	mutex_lock(&sma6201->lock);
+	if (value < sma6201->check_thermal_vbat_period_min)
+		ret = -EINVAL;
+	else
+		sma6201->check_thermal_vbat_period_max = value;
+	mutex_unlock(&sma6201->lock);
+
+	return ret ? ret : (ssize_t)count;
+}
+
+static DEVICE_ATTR_RW(check_thermal_vbat_period_max);
+
+/* Effective period of the next poll in sec, 0 : not polling */
+static ssize_t check_thermal_vbat_period_cur_show(struct device *dev,
+	struct device_attribute *devattr, char *buf)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int rc;
+
+	rc = (int)snprintf(buf, PAGE_SIZE,
+			"%ld\n", sma6201->check_thermal_vbat_period_cur);
+
+	return (ssize_t)rc;
+}
+
+static DEVICE_ATTR_RO(check_thermal_vbat_period_cur);
+
+static ssize_t check_thermal_vbat_wakeups_show(struct device *dev,
+	struct device_attribute *devattr, char *buf)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int rc;
+
+	rc = (int)snprintf(buf, PAGE_SIZE,
+			"%lu\n", sma6201->check_thermal_vbat_wakeups);
+
+	return (ssize_t)rc;
+}
+
+static DEVICE_ATTR_RO(check_thermal_vbat_wakeups);
 
 static ssize_t check_thermal_vbat_enable_show(struct device *dev,
 	struct device_attribute *devattr, char *buf)
@@ -5837,6 +7733,12 @@ static ssize_t check_thermal_vbat_enable_store(struct device *dev,
 	if (ret)
 		return -EINVAL;
 
+	if (sma6201->check_thermal_vbat_enable) {
+		mutex_lock(&sma6201->lock);
+		sma6201_get_thermal_zone(sma6201);
+		mutex_unlock(&sma6201->lock);
+	}
+
 	return (ssize_t)count;
 }
 
@@ -6159,16 +8061,24 @@ static ssize_t check_thermal_sensor_opt_store(struct device *dev,
 	struct device_attribute *devattr, const char *buf, size_t count)
 {
 	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	long opt;
 	int ret;
 
-	ret = kstrtol(buf, 10, &sma6201->thermal_sense_opt);
+	ret = kstrtol(buf, 10, &opt);
 
-	if (ret || (sma6201->thermal_sense_opt != 1
-			&& sma6201->thermal_sense_opt != 2)){
-		sma6201->thermal_sense_opt = 1;
-		return -EINVAL;
+	if (ret || (opt != 1 && opt != 2)) {
+		opt = 1;
+		ret = -EINVAL;
 	}
-	return (ssize_t)count;
+
+	/* The selected zone changed, unbind from the previous one */
+	mutex_lock(&sma6201->lock);
+	sma6201_put_thermal_zone(sma6201);
+	sma6201->thermal_sense_opt = opt;
+	sma6201_get_thermal_zone(sma6201);
+	mutex_unlock(&sma6201->lock);
+
+	return ret ? ret : (ssize_t)count;
 }
 
 static DEVICE_ATTR_RW(check_thermal_sensor_opt);
@@ -6196,6 +8106,8 @@ static ssize_t delayed_shutdown_enable_store(struct device *dev,
 	if (ret)
 		return -EINVAL;
 
+	sma6201_update_autosuspend_delay(sma6201);
+
 	return (ssize_t)count;
 }
 
@@ -6224,13 +8136,49 @@ static ssize_t delayed_time_shutdown_store(struct device *dev,
 	if (ret)
 		return -EINVAL;
 
+	sma6201_update_autosuspend_delay(sma6201);
+
 	return (ssize_t)count;
 }
 
 static DEVICE_ATTR_RW(delayed_time_shutdown);
 
+static ssize_t warm_standby_time_show(struct device *dev,
+	struct device_attribute *devattr, char *buf)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int rc;
+
+	rc = (int)snprintf(buf, PAGE_SIZE,
+			"%ld\n", sma6201->warm_standby_time);
+
+	return (ssize_t)rc;
+}
+
+static ssize_t warm_standby_time_store(struct device *dev,
+	struct device_attribute *devattr, const char *buf, size_t count)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int ret;
+
+	ret = kstrtol(buf, 10, &sma6201->warm_standby_time);
+
+	if (ret)
+		return -EINVAL;
+
+	sma6201_update_autosuspend_delay(sma6201);
+
+	return (ssize_t)count;
+}
+
+static DEVICE_ATTR_RW(warm_standby_time);
+
 static struct attribute *sma6201_attr[] = {
 	&dev_attr_check_thermal_vbat_period.attr,
+	&dev_attr_check_thermal_vbat_period_min.attr,
+	&dev_attr_check_thermal_vbat_period_max.attr,
+	&dev_attr_check_thermal_vbat_period_cur.attr,
+	&dev_attr_check_thermal_vbat_wakeups.attr,
 	&dev_attr_check_thermal_vbat_enable.attr,
 	&dev_attr_check_thermal_table.attr,
 	&dev_attr_check_thermal_value.attr,
@@ -6246,6 +8194,7 @@ static struct attribute *sma6201_attr[] = {
 	&dev_attr_check_thermal_sensor_opt.attr,
 	&dev_attr_delayed_shutdown_enable.attr,
 	&dev_attr_delayed_time_shutdown.attr,
+	&dev_attr_warm_standby_time.attr,
 	NULL,
 };
 
@@ -6254,6 +8203,401 @@ static struct attribute_group sma6201_attr_group = {
 	.name = "thermal_comp",
 };
 
+static int sma6201_class_h_stats_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_scene_stats *stats = &sma6201->scene_stats;
+
+	seq_printf(s, "mode : %u\n", sma6201->voice_music_class_h_mode);
+	seq_printf(s, "switches : %u\n", stats->switches);
+	seq_printf(s, "last writes : %u\n", stats->last_writes);
+	seq_printf(s, "total writes : %llu\n", stats->total_writes);
+	seq_printf(s, "last latency : %lld us\n", stats->last_latency_us);
+	seq_printf(s, "max latency : %lld us\n", stats->max_latency_us);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sma6201_class_h_stats);
+
+static int sma6201_startup_ready_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_ready_stats *stats = &sma6201->ready_stats;
+	int i;
+
+	seq_printf(s, "count : %u\n", stats->count);
+	seq_printf(s, "timeouts : %u\n", stats->timeouts);
+	seq_printf(s, "errors : %u\n", stats->errors);
+	if (!stats->count)
+		return 0;
+
+	seq_printf(s, "min : %lld us\n", stats->min_us);
+	seq_printf(s, "avg : %lld us\n", div_s64(stats->total_us, stats->count));
+	seq_printf(s, "max : %lld us\n", stats->max_us);
+	for (i = 0; i < STARTUP_READY_HIST_BUCKETS; i++) {
+		if (!stats->hist[i])
+			continue;
+		if (i == STARTUP_READY_HIST_BUCKETS - 1)
+			seq_printf(s, "  >= %dms : %u\n", i, stats->hist[i]);
+		else
+			seq_printf(s, "  %d ~ %dms : %u\n", i, i + 1,
+					stats->hist[i]);
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sma6201_startup_ready);
+
+static int sma6201_pm_stats_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_pm_stats *stats = &sma6201->pm_stats;
+
+	seq_printf(s, "runtime status : %s\n",
+		pm_runtime_suspended(sma6201->dev) ? "suspended" : "active");
+	seq_printf(s, "suspends : %u\n", stats->suspends);
+	seq_printf(s, "resumes : %u\n", stats->resumes);
+	seq_printf(s, "warm starts : %u\n", stats->warm_starts);
+	seq_printf(s, "standbys : %u\n", stats->standbys);
+	if (!stats->resumes)
+		return 0;
+
+	seq_printf(s, "last resume : %lld us\n", stats->last_resume_us);
+	seq_printf(s, "avg resume : %lld us\n",
+		div_s64(stats->total_resume_us, stats->resumes));
+	seq_printf(s, "max resume : %lld us\n", stats->max_resume_us);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sma6201_pm_stats);
+
+static int sma6201_start_stats_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_start_stats *stats = &sma6201->start_stats;
+	unsigned long flags;
+
+	/* seq_printf() only fills the seq buffer, no sleep under the lock */
+	spin_lock_irqsave(&stats->lock, flags);
+
+	seq_printf(s, "mode : %s\n",
+		sma6201->async_startup ? "async" : "sync");
+	seq_printf(s, "dac power ups : %u\n", stats->blocks);
+	if (stats->blocks) {
+		seq_printf(s, "last dapm block : %lld us\n",
+			stats->last_block_us);
+		seq_printf(s, "avg dapm block : %lld us\n",
+			div_s64(stats->total_block_us, stats->blocks));
+		seq_printf(s, "max dapm block : %lld us\n",
+			stats->max_block_us);
+	}
+
+	seq_printf(s, "stream starts : %u\n", stats->count);
+	if (!stats->count)
+		goto out;
+
+	seq_printf(s, "last trigger to sound : %lld us\n",
+		stats->last_trigger_us);
+	seq_printf(s, "avg trigger to sound : %lld us\n",
+		div_s64(stats->total_trigger_us, stats->count));
+	seq_printf(s, "max trigger to sound : %lld us\n",
+		stats->max_trigger_us);
+	seq_printf(s, "last power up to sound : %lld us\n",
+		stats->last_sound_us);
+	seq_printf(s, "avg power up to sound : %lld us\n",
+		div_s64(stats->total_sound_us, stats->count));
+	seq_printf(s, "max power up to sound : %lld us\n",
+		stats->max_sound_us);
+out:
+	spin_unlock_irqrestore(&stats->lock, flags);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sma6201_start_stats);
+
+static int sma6201_phase_cmp(const void *a, const void *b)
+{
+	u32 x = *(const u32 *)a, y = *(const u32 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static int sma6201_phases_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	unsigned long long count;
+	u32 *samples;
+	u64 total;
+	int phase, n, i;
+
+	samples = kmalloc_array(SMA6201_PHASE_WINDOW, sizeof(u32),
+			GFP_KERNEL);
+	if (!samples)
+		return -ENOMEM;
+
+	seq_printf(s, "%-14s %8s %10s %10s %10s %10s\n", "phase", "count",
+		"min(us)", "avg(us)", "max(us)", "p99(us)");
+
+	for (phase = 0; phase < SMA6201_PHASE_MAX; phase++) {
+		spin_lock(&sma6201->phase_lock);
+		count = sma6201->phases[phase].count;
+		n = min_t(unsigned long long, count, SMA6201_PHASE_WINDOW);
+		memcpy(samples, sma6201->phases[phase].samples_us,
+				n * sizeof(u32));
+		spin_unlock(&sma6201->phase_lock);
+
+		if (!n)
+			continue;
+
+		/* Statistics over the last SMA6201_PHASE_WINDOW samples */
+		sort(samples, n, sizeof(u32), sma6201_phase_cmp, NULL);
+		for (i = 0, total = 0; i < n; i++)
+			total += samples[i];
+
+		seq_printf(s, "%-14s %8llu %10u %10llu %10u %10u\n",
+			sma6201_phase_names[phase], count, samples[0],
+			div_u64(total, n), samples[n - 1],
+			samples[DIV_ROUND_UP(n * 99, 100) - 1]);
+	}
+
+	kfree(samples);
+
+	return 0;
+}
+
+static ssize_t sma6201_phases_write(struct file *file,
+		const char __user *buf, size_t count, loff_t *ppos)
+{
+	struct sma6201_priv *sma6201 =
+		((struct seq_file *)file->private_data)->private;
+
+	spin_lock(&sma6201->phase_lock);
+	memset(sma6201->phases, 0, sizeof(sma6201->phases));
+	spin_unlock(&sma6201->phase_lock);
+
+	return count;
+}
+
+static int sma6201_phases_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sma6201_phases_show, inode->i_private);
+}
+
+static const struct file_operations sma6201_phases_fops = {
+	.owner = THIS_MODULE,
+	.open = sma6201_phases_open,
+	.read = seq_read,
+	.write = sma6201_phases_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+/* Bus reads/writes per register, registers without traffic are left out.
+ * EQ bank registers are listed at their regmap address(0x100 ~).
+ */
+static int sma6201_io_regs_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+	unsigned int reads, writes;
+	int reg;
+
+	seq_printf(s, "%-5s %10s %10s\n", "reg", "reads", "writes");
+
+	for (reg = 0; reg <= SMA6201_EQ_BANK_MAX; reg++) {
+		spin_lock(&io->lock);
+		reads = io->reads[reg];
+		writes = io->writes[reg];
+		spin_unlock(&io->lock);
+
+		if (reads || writes)
+			seq_printf(s, "0x%03x %10u %10u\n", reg, reads, writes);
+	}
+
+	return 0;
+}
+
+static ssize_t sma6201_io_regs_write(struct file *file,
+		const char __user *buf, size_t count, loff_t *ppos)
+{
+	struct sma6201_priv *sma6201 =
+		((struct seq_file *)file->private_data)->private;
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+
+	spin_lock(&io->lock);
+	memset(io->reads, 0, sizeof(io->reads));
+	memset(io->writes, 0, sizeof(io->writes));
+	spin_unlock(&io->lock);
+
+	return count;
+}
+
+static int sma6201_io_regs_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sma6201_io_regs_show, inode->i_private);
+}
+
+static const struct file_operations sma6201_io_regs_fops = {
+	.owner = THIS_MODULE,
+	.open = sma6201_io_regs_open,
+	.read = seq_read,
+	.write = sma6201_io_regs_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+/* Register access calls, bus transfers and call latency per site */
+static int sma6201_io_sites_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+	struct sma6201_io_site_stats stats;
+	int site;
+
+	seq_printf(s, "%-14s %10s %10s %12s %10s\n", "site", "calls",
+		"xfers", "total(us)", "max(us)");
+
+	for (site = 0; site < SMA6201_IO_SITE_MAX; site++) {
+		spin_lock(&io->lock);
+		stats = io->site[site];
+		spin_unlock(&io->lock);
+
+		if (!stats.calls)
+			continue;
+
+		seq_printf(s, "%-14s %10llu %10llu %12llu %10llu\n",
+			sma6201_io_site_names[site], stats.calls, stats.xfers,
+			div_u64(stats.time_ns, NSEC_PER_USEC),
+			div_u64(stats.max_ns, NSEC_PER_USEC));
+	}
+
+	return 0;
+}
+
+static ssize_t sma6201_io_sites_write(struct file *file,
+		const char __user *buf, size_t count, loff_t *ppos)
+{
+	struct sma6201_priv *sma6201 =
+		((struct seq_file *)file->private_data)->private;
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+
+	spin_lock(&io->lock);
+	memset(io->site, 0, sizeof(io->site));
+	spin_unlock(&io->lock);
+
+	return count;
+}
+
+static int sma6201_io_sites_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sma6201_io_sites_show, inode->i_private);
+}
+
+static const struct file_operations sma6201_io_sites_fops = {
+	.owner = THIS_MODULE,
+	.open = sma6201_io_sites_open,
+	.read = seq_read,
+	.write = sma6201_io_sites_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+/* Latency histogram per access type of the calls with a bus transfer */
+static int sma6201_io_latency_show(struct seq_file *s, void *data)
+{
+	struct sma6201_priv *sma6201 = s->private;
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+	unsigned int hist[SMA6201_IO_OP_MAX][SMA6201_IO_HIST_BUCKETS];
+	char range[16];
+	int op, i;
+
+	spin_lock(&io->lock);
+	memcpy(hist, io->hist, sizeof(hist));
+	spin_unlock(&io->lock);
+
+	seq_printf(s, "%-12s", "latency(us)");
+	for (op = 0; op < SMA6201_IO_OP_MAX; op++)
+		seq_printf(s, " %11s", sma6201_io_op_names[op]);
+	seq_puts(s, "\n");
+
+	for (i = 0; i < SMA6201_IO_HIST_BUCKETS; i++) {
+		if (i == 0)
+			snprintf(range, sizeof(range), "< 1");
+		else if (i == SMA6201_IO_HIST_BUCKETS - 1)
+			snprintf(range, sizeof(range), ">= %u", 1U << (i - 1));
+		else
+			snprintf(range, sizeof(range), "%u ~ %u",
+					1U << (i - 1), 1U << i);
+
+		seq_printf(s, "%-12s", range);
+		for (op = 0; op < SMA6201_IO_OP_MAX; op++)
+			seq_printf(s, " %11u", hist[op][i]);
+		seq_puts(s, "\n");
+	}
+
+	return 0;
+}
+
+static ssize_t sma6201_io_latency_write(struct file *file,
+		const char __user *buf, size_t count, loff_t *ppos)
+{
+	struct sma6201_priv *sma6201 =
+		((struct seq_file *)file->private_data)->private;
+	struct sma6201_io_stats *io = &sma6201->io_stats;
+
+	spin_lock(&io->lock);
+	memset(io->hist, 0, sizeof(io->hist));
+	spin_unlock(&io->lock);
+
+	return count;
+}
+
+static int sma6201_io_latency_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sma6201_io_latency_show, inode->i_private);
+}
+
+static const struct file_operations sma6201_io_latency_fops = {
+	.owner = THIS_MODULE,
+	.open = sma6201_io_latency_open,
+	.read = seq_read,
+	.write = sma6201_io_latency_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static void sma6201_debugfs_init(struct sma6201_priv *sma6201)
+{
+	char name[32];
+
+	snprintf(name, sizeof(name), "sma6201-%s", dev_name(sma6201->dev));
+	sma6201->debugfs_root = debugfs_create_dir(name, NULL);
+	if (IS_ERR_OR_NULL(sma6201->debugfs_root)) {
+		sma6201->debugfs_root = NULL;
+		return;
+	}
+
+	debugfs_create_file("class_h_stats", 0444, sma6201->debugfs_root,
+			sma6201, &sma6201_class_h_stats_fops);
+	debugfs_create_file("startup_ready", 0444, sma6201->debugfs_root,
+			sma6201, &sma6201_startup_ready_fops);
+	debugfs_create_file("pm_stats", 0444, sma6201->debugfs_root,
+			sma6201, &sma6201_pm_stats_fops);
+	debugfs_create_file("start_stats", 0444, sma6201->debugfs_root,
+			sma6201, &sma6201_start_stats_fops);
+	debugfs_create_file("phases", 0644, sma6201->debugfs_root,
+			sma6201, &sma6201_phases_fops);
+	debugfs_create_file("io_regs", 0644, sma6201->debugfs_root,
+			sma6201, &sma6201_io_regs_fops);
+	debugfs_create_file("io_sites", 0644, sma6201->debugfs_root,
+			sma6201, &sma6201_io_sites_fops);
+	debugfs_create_file("io_latency", 0644, sma6201->debugfs_root,
+			sma6201, &sma6201_io_latency_fops);
+	/* 0 : power up inside the DAC event as before, for comparison */
+	debugfs_create_bool("async_startup", 0644, sma6201->debugfs_root,
+			&sma6201->async_startup);
+}
+
 static int sma6201_probe(struct snd_soc_component *component)
 {
 	struct sma6201_priv *sma6201 = snd_soc_component_get_drvdata(component);
@@ -6296,6 +8640,10 @@ static int sma6201_probe(struct snd_soc_component *component)
 	if (dapm_widget_str != NULL)
 		kfree(dapm_widget_str);
 
+	ret = sma6201_wait_tuning_done(sma6201);
+	if (ret)
+		return ret;
+
 	sma6201_reset(component);
 
 	ret = kfifo_alloc(&sma6201->data_fifo,
@@ -6303,10 +8651,7 @@ static int sma6201_probe(struct snd_soc_component *component)
 		GFP_KERNEL);
 	if (ret)
 		dev_err(component->dev, "%s: fifo alloc failed\n", __func__);
-	else {
-		wakeup_source_init(&sma6201->shutdown_wakesrc,
-					"shutdown_wakesrc");
-	}
+
 	return ret;
 }
 
@@ -6316,9 +8661,13 @@ static void sma6201_remove(struct snd_soc_component *component)
 
 	dev_info(component->dev, "%s\n", __func__);
 
+	cancel_work_sync(&sma6201->startup_work);
+	cancel_delayed_work_sync(&sma6201->standby_work);
 	sma6201_set_bias_level(component, SND_SOC_BIAS_OFF);
-	devm_free_irq(sma6201->dev, sma6201->irq, sma6201);
-	devm_kfree(sma6201->dev, sma6201);
+	/* Power down now instead of after the autosuspend delay,
+	 * runtime PM is still enabled here(see sma6201_i2c_remove)
+	 */
+	pm_runtime_suspend(sma6201->dev);
 
 	kfifo_free(&sma6201->data_fifo);
 }
@@ -6326,8 +8675,7 @@ static void sma6201_remove(struct snd_soc_component *component)
 static const struct snd_soc_component_driver sma6201_component = {
 	.probe = sma6201_probe,
 	.remove = sma6201_remove,
-	.suspend = sma6201_suspend,
-	.resume = sma6201_resume,
+	.set_bias_level = sma6201_set_bias_level,
 	.controls = sma6201_snd_controls,
 	.num_controls = ARRAY_SIZE(sma6201_snd_controls),
 	.dapm_widgets = sma6201_dapm_widgets,
@@ -6336,16 +8684,32 @@ static const struct snd_soc_component_driver sma6201_component = {
 	.num_dapm_routes = ARRAY_SIZE(sma6201_audio_map),
 };
 
+static const struct regmap_range_cfg sma6201_ranges[] = {
+	{
+		.name = "EQ Bank",
+		.range_min = SMA6201_EQ1_BANK_BASE,
+		.range_max = SMA6201_EQ_BANK_MAX,
+		.selector_reg = SMA6201_2B_EQ_MODE,
+		.selector_mask = EQ_BANK_SEL_MASK,
+		.selector_shift = 3,
+		.window_start = SMA6201_EQ_WINDOW_START,
+		.window_len = SMA6201_EQ_WINDOW_LEN,
+	},
+};
+
 const struct regmap_config sma_i2c_regmap = {
 	.reg_bits = 8,
 	.val_bits = 8,
 
-	.max_register = SMA6201_FF_VERSION,
+	.max_register = SMA6201_EQ_BANK_MAX,
 	.readable_reg = sma6201_readable_register,
 	.writeable_reg = sma6201_writeable_register,
 	.volatile_reg = sma6201_volatile_register,
 
-	.cache_type = REGCACHE_NONE,
+	.ranges = sma6201_ranges,
+	.num_ranges = ARRAY_SIZE(sma6201_ranges),
+
+	.cache_type = REGCACHE_RBTREE,
 	.reg_defaults = sma6201_reg_def,
 	.num_reg_defaults = ARRAY_SIZE(sma6201_reg_def),
 };
@@ -6358,6 +8722,7 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 	int ret;
 	u32 value, value_clk;
 	unsigned int device_info;
+	ktime_t start = ktime_get();
 
 	dev_info(&client->dev, "%s is here. Driver version REV009\n", __func__);
 
@@ -6367,6 +8732,12 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 	if (!sma6201)
 		return -ENOMEM;
 
+	sma6201->dev = &client->dev;
+	spin_lock_init(&sma6201->start_stats.lock);
+	spin_lock_init(&sma6201->phase_lock);
+	spin_lock_init(&sma6201->io_stats.lock);
+	mutex_init(&sma6201->shadow.lock);
+
 	sma6201->regmap = devm_regmap_init_i2c(client, &sma_i2c_regmap);
 	if (IS_ERR(sma6201->regmap)) {
 		ret = PTR_ERR(sma6201->regmap);
@@ -6478,22 +8849,36 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 		sma6201_check_thermal_fault_worker);
 	INIT_DELAYED_WORK(&sma6201->check_thermal_vbat_work,
 		sma6201_check_thermal_vbat_worker);
-	INIT_DELAYED_WORK(&sma6201->delayed_shutdown_work,
-		sma6201_delayed_shutdown_worker);
+	INIT_WORK(&sma6201->temp_work, sma6201_temp_event_worker);
+	sma6201->vbat_status = -1;
+#ifdef CONFIG_SMA6201_BATTERY_READING
+	INIT_WORK(&sma6201->vbat_work, sma6201_vbat_worker);
+#endif
+	INIT_DELAYED_WORK(&sma6201->standby_work,
+		sma6201_standby_worker);
+	INIT_WORK(&sma6201->startup_work, sma6201_startup_worker);
+	/* No startup pending */
+	init_completion(&sma6201->startup_done);
+	complete_all(&sma6201->startup_done);
+	INIT_WORK(&sma6201->tuning_work, sma6201_tuning_worker);
+	init_completion(&sma6201->tuning_done);
+	complete_all(&sma6201->tuning_done);
+	sma6201->async_startup = true;
 
 	mutex_init(&sma6201->lock);
+	mutex_init(&sma6201->mute_lock);
 	sma6201->check_thermal_vbat_period = CHECK_COMP_PERIOD_TIME;
+	sma6201->check_thermal_vbat_period_min = CHECK_COMP_PERIOD_MIN;
+	sma6201->check_thermal_vbat_period_max = CHECK_COMP_PERIOD_MAX;
 	sma6201->check_thermal_fault_period = CHECK_FAULT_PERIOD_TIME;
 	sma6201->delayed_time_shutdown = DELAYED_SHUTDOWN_TIME;
+	sma6201->warm_standby_time = WARM_STANDBY_TIME;
 	sma6201->threshold_level = 0;
 	sma6201->enable_ocp_aging = 0;
 	sma6201->temp_table_number = 0;
-	sma6201->last_rate = 0;
-	sma6201->last_width = 0;
-	sma6201->last_channel = 0;
+	sma6201->pll_ref_clk = 0;
 
 	sma6201->devtype = id->driver_data;
-	sma6201->dev = &client->dev;
 	sma6201->kobj = &client->dev.kobj;
 	sma6201->irq = -1;
 	sma6201->pll_matches = sma6201_pll_matches;
@@ -6502,6 +8887,26 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 	sma6201->num_of_temperature_matches =
 		ARRAY_SIZE(sma6201_temperature_gain_matches);
 
+	/* State to gain map of the cooling device, the table by default */
+	ret = np ? of_property_count_u32_elems(np, "cooling-gains") : -EINVAL;
+	if (ret > 0) {
+		int i;
+
+		sma6201->temp_match = devm_kmemdup(&client->dev,
+			sma6201_temperature_gain_matches,
+			sizeof(sma6201_temperature_gain_matches), GFP_KERNEL);
+		if (!sma6201->temp_match)
+			return -ENOMEM;
+
+		for (i = 0; i < min_t(int, ret,
+			sma6201->num_of_temperature_matches); i++) {
+			of_property_read_u32_index(np, "cooling-gains", i,
+				&value);
+			sma6201->temp_match[i].comp_gain = value;
+		}
+		dev_info(&client->dev, "%d cooling gains from DT\n", ret);
+	}
+
 	if (gpio_is_valid(sma6201->gpio_int)) {
 
 		dev_info(&client->dev, "%s , i2c client name: %s\n",
@@ -6528,11 +8933,7 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 				dev_err(&client->dev, "failed to request IRQ(%u) [%d]\n",
 						sma6201->irq, ret);
 				sma6201->irq = -1;
-				i2c_set_clientdata(client, NULL);
-				devm_free_irq(&client->dev,
-						sma6201->irq, sma6201);
-				devm_kfree(&client->dev, sma6201);
-				return ret;
+				goto err_irq;
 			}
 			disable_irq((unsigned int)sma6201->irq);
 		}
@@ -6542,11 +8943,16 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 	}
 
 	if (gpio_is_valid(sma6201->gpio_reset)) {
-		if (gpio_request(sma6201->gpio_reset, "sma6201-reset") < 0)
+		if (gpio_request(sma6201->gpio_reset, "sma6201-reset") < 0) {
 			dev_err(&client->dev, "gpio_request failed\n");
-		if (gpio_direction_output(sma6201->gpio_reset, 1) < 0)
-			dev_err(&client->dev, "gpio_direction_output failed\n");
-		gpio_set_value(sma6201->gpio_reset, 1);
+			/* Not ours, left alone and not freed */
+			sma6201->gpio_reset = -EBUSY;
+		} else {
+			if (gpio_direction_output(sma6201->gpio_reset, 1) < 0)
+				dev_err(&client->dev,
+					"gpio_direction_output failed\n");
+			gpio_set_value(sma6201->gpio_reset, 1);
+		}
 	} else {
 		dev_err(&client->dev, "reset signal output pin is not found\n");
 	}
@@ -6563,28 +8969,119 @@ static int sma6201_i2c_probe(struct i2c_client *client,
 	sma6201->lowbattery_status = -1;
 	sma6201->thermal_sense_opt = -1;
 
-	ret = regmap_read(sma6201->regmap, SMA6201_FF_VERSION, &device_info);
+	ret = sma6201_io_read(sma6201, SMA6201_IO_PROBE, SMA6201_FF_VERSION,
+			&device_info);
 
 	if ((ret != 0) || ((device_info & 0xF8) != DEVICE_ID)) {
 		dev_err(&client->dev, "device initialization error (%d 0x%02X)",
 				ret, device_info);
-		return -ENODEV;
+		ret = -ENODEV;
+		goto err_reset;
 	}
 	dev_info(&client->dev, "chip version 0x%02X\n", device_info);
+	sma6201->rev_num = device_info & REV_NUM_STATUS;
+
+	ret = sma6201_sync_reg_defaults(sma6201);
+	if (ret) {
+		dev_err(&client->dev, "failed to sync register defaults (%d)\n",
+				ret);
+		goto err_reset;
+	}
+
+	sma6201->cache_snapshot = devm_kzalloc(&client->dev,
+			SMA6201_EQ_BANK_MAX + 1, GFP_KERNEL);
+	if (!sma6201->cache_snapshot) {
+		ret = -ENOMEM;
+		goto err_reset;
+	}
+
+	ret = sma6201_build_init_image(sma6201);
+	if (ret) {
+		dev_err(&client->dev, "failed to build init image (%d)\n", ret);
+		goto err_reset;
+	}
+
+	sma6201_debugfs_init(sma6201);
+
+	/* Bound on registration by the platform cooling maps if any */
+	sma6201->gain_cdev = thermal_of_cooling_device_register(np,
+		"sma6201-spk-gain", sma6201, &sma6201_gain_cdev_ops);
+	if (IS_ERR(sma6201->gain_cdev)) {
+		dev_dbg(&client->dev, "%s : no speaker gain cooling device\n",
+			__func__);
+		sma6201->gain_cdev = NULL;
+	} else {
+		sma6201->gain_cdev_mapped = sma6201_gain_cdev_mapped(np);
+	}
+
+#ifdef CONFIG_SMA6201_BATTERY_READING
+	sma6201->psy_nb.notifier_call = sma6201_psy_notifier;
+	ret = power_supply_reg_notifier(&sma6201->psy_nb);
+	if (ret) {
+		dev_err(&client->dev, "%s : power supply notifier fail %d\n",
+			__func__, ret);
+		goto err_psy;
+	}
+#endif
+
+	/* Idle power down through runtime PM autosuspend,
+	 * suspended(cache only) from the reset in component probe
+	 */
+	pm_runtime_use_autosuspend(&client->dev);
+	sma6201_update_autosuspend_delay(sma6201);
+	pm_runtime_enable(&client->dev);
+
+	/* EQ upload in the background until the component probe */
+	reinit_completion(&sma6201->tuning_done);
+	schedule_work(&sma6201->tuning_work);
 
 	ret = snd_soc_register_component(&client->dev,
 		&sma6201_component, sma6201_dai,
 		ARRAY_SIZE(sma6201_dai));
+	if (ret) {
+		dev_err(&client->dev, "failed to register component [%d]\n",
+				ret);
+		goto err_component;
+	}
 
 	/* Create sma6201 sysfs attributes */
 	sma6201->attr_grp = &sma6201_attr_group;
 	ret = sysfs_create_group(sma6201->kobj, sma6201->attr_grp);
-
 	if (ret) {
-		pr_err("failed to create attribute group [%d]\n", ret);
+		dev_err(&client->dev, "failed to create attribute group [%d]\n",
+				ret);
 		sma6201->attr_grp = NULL;
+		goto err_sysfs;
 	}
 
+	sma6201_phase_end(sma6201, SMA6201_PHASE_PROBE, start);
+
+	return 0;
+
+err_sysfs:
+	snd_soc_unregister_component(&client->dev);
+err_component:
+	cancel_work_sync(&sma6201->tuning_work);
+	pm_runtime_disable(&client->dev);
+	pm_runtime_dont_use_autosuspend(&client->dev);
+#ifdef CONFIG_SMA6201_BATTERY_READING
+	power_supply_unreg_notifier(&sma6201->psy_nb);
+	cancel_work_sync(&sma6201->vbat_work);
+err_psy:
+#endif
+	if (sma6201->gain_cdev)
+		thermal_cooling_device_unregister(sma6201->gain_cdev);
+	cancel_work_sync(&sma6201->temp_work);
+	debugfs_remove_recursive(sma6201->debugfs_root);
+err_reset:
+	if (gpio_is_valid(sma6201->gpio_reset))
+		gpio_free(sma6201->gpio_reset);
+err_irq:
+	if (sma6201->irq >= 0)
+		free_irq(sma6201->irq, sma6201);
+	if (gpio_is_valid(sma6201->gpio_int))
+		gpio_free(sma6201->gpio_int);
+
 	return ret;
 }
 
@@ -6595,19 +9092,87 @@ static int sma6201_i2c_remove(struct i2c_client *client)
 
 	dev_info(&client->dev, "%s\n", __func__);
 
-	if (sma6201->irq < 0)
-		devm_free_irq(&client->dev, sma6201->irq, sma6201);
-
-	if (sma6201) {
+	/* Reverse order of sma6201_i2c_probe */
+	if (sma6201->attr_grp)
 		sysfs_remove_group(sma6201->kobj, sma6201->attr_grp);
-		devm_kfree(&client->dev, sma6201);
-	}
 
+	/* The component remove powers the amp down through runtime PM */
 	snd_soc_unregister_component(&client->dev);
 
+	cancel_work_sync(&sma6201->tuning_work);
+	pm_runtime_disable(&client->dev);
+	pm_runtime_dont_use_autosuspend(&client->dev);
+
+	cancel_work_sync(&sma6201->startup_work);
+	cancel_delayed_work_sync(&sma6201->standby_work);
+	cancel_delayed_work_sync(&sma6201->check_thermal_fault_work);
+	cancel_delayed_work_sync(&sma6201->check_thermal_vbat_work);
+#ifdef CONFIG_SMA6201_BATTERY_READING
+	power_supply_unreg_notifier(&sma6201->psy_nb);
+	cancel_work_sync(&sma6201->vbat_work);
+#endif
+	mutex_lock(&sma6201->lock);
+	sma6201_put_thermal_handles(sma6201);
+	mutex_unlock(&sma6201->lock);
+	if (sma6201->gain_cdev)
+		thermal_cooling_device_unregister(sma6201->gain_cdev);
+	cancel_work_sync(&sma6201->temp_work);
+	debugfs_remove_recursive(sma6201->debugfs_root);
+
+	if (gpio_is_valid(sma6201->gpio_reset))
+		gpio_free(sma6201->gpio_reset);
+	if (sma6201->irq >= 0)
+		free_irq(sma6201->irq, sma6201);
+	if (gpio_is_valid(sma6201->gpio_int))
+		gpio_free(sma6201->gpio_int);
+
 	return 0;
 }
 
+#ifdef CONFIG_PM_SLEEP
+/* A running amp is muted and powered down for system suspend,
+ * resume powers it up again for the stream that is still open
+ */
+static int sma6201_pm_suspend(struct device *dev)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int ret;
+
+	ret = sma6201_wait_startup_done(sma6201);
+	if (ret)
+		return ret;
+
+	sma6201->pm_restart = sma6201->amp_power_status;
+	if (sma6201->pm_restart)
+		sma6201_power_down(sma6201);
+
+	return pm_runtime_force_suspend(dev);
+}
+
+static int sma6201_pm_resume(struct device *dev)
+{
+	struct sma6201_priv *sma6201 = dev_get_drvdata(dev);
+	int ret;
+
+	ret = pm_runtime_force_resume(dev);
+	if (ret < 0)
+		return ret;
+
+	if (!sma6201->pm_restart)
+		return 0;
+
+	sma6201->pm_restart = false;
+
+	return sma6201_power_up(sma6201);
+}
+#endif
+
+static const struct dev_pm_ops sma6201_pm_ops = {
+	SET_SYSTEM_SLEEP_PM_OPS(sma6201_pm_suspend, sma6201_pm_resume)
+	SET_RUNTIME_PM_OPS(sma6201_runtime_suspend, sma6201_runtime_resume,
+			NULL)
+};
+
 static const struct i2c_device_id sma6201_i2c_id[] = {
 	{"sma6201", 0},
 	{}
@@ -6624,6 +9189,8 @@ static struct i2c_driver sma6201_i2c_driver = {
 	.driver = {
 		.name = "sma6201",
 		.of_match_table = sma6201_of_match,
+		.pm = &sma6201_pm_ops,
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
 	.probe = sma6201_i2c_probe,
 	.remove = sma6201_i2c_remove,
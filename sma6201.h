@@ -235,6 +235,21 @@
 #define	 SMA6201_FE_STATUS5		    0xfe
 #define	 SMA6201_FF_VERSION	        0xff
 
+/* EQ1/EQ2 Bank Virtual Register Addresses
+ * 0x40 ~ 0x8A window is paged by EQ_BANK_SEL of 0x2B
+ */
+#define  SMA6201_EQ_WINDOW_START	SMA6201_40_EQ_CTRL1
+#define  SMA6201_EQ_WINDOW_LEN		75
+#define  SMA6201_EQ1_BANK_BASE		0x100
+#define  SMA6201_EQ2_BANK_BASE		(SMA6201_EQ1_BANK_BASE + \
+					SMA6201_EQ_WINDOW_LEN)
+#define  SMA6201_EQ_BANK_MAX		(SMA6201_EQ2_BANK_BASE + \
+					SMA6201_EQ_WINDOW_LEN - 1)
+#define  SMA6201_EQ1_REG(reg)	((reg) - SMA6201_EQ_WINDOW_START + \
+					SMA6201_EQ1_BANK_BASE)
+#define  SMA6201_EQ2_REG(reg)	((reg) - SMA6201_EQ_WINDOW_START + \
+					SMA6201_EQ2_BANK_BASE)
+
 /* SMA6201 Registers Bit Fields */
 
 /* SYSTEM_CTRL : 0x00 */
@@ -441,6 +456,15 @@
 #define THERMAL_160_120 (1<<5)
 #define THERMAL_140_100 (2<<5)
 
+/* PLL_F3,P,CP : 0x8F */
+#define PLL_F3_MASK (15<<4)
+#define PLL_F3_SHIFT 4
+#define PLL_P_MASK (3<<2)
+#define PLL_P_SHIFT 2
+#define PLL_CP_MASK (3<<0)
+#define PLL_CP_2 (2<<0)
+#define PLL_CP_3 (3<<0)
+
 /* CLASS-H CONTROL LEVEL2 : 0x91 */
 #define CLASS_H_ATTACK_LVL_MASK (15<<4)
 
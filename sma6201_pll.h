@@ -0,0 +1,100 @@
+/*
+ * sma6201_pll.h -- sma6201 PLL setting table and divider solver
+ *
+ * Copyright 2023 Iron Device Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Kept free of kernel headers so that test/sma6201_pll_test.c can
+ * build it on the host, include it after sma6201.h.
+ */
+
+#ifndef _SMA6201_PLL_H
+#define _SMA6201_PLL_H
+
+/* PLL solver : VCO = (input >> P) * (N + F / 2^20),
+ * 24.576MHz out of the VCO with POST_N 7(/14)
+ */
+#define PLL_VCO_FREQ 344064000
+#define PLL_POST_N 0x07
+#define PLL_PFD_MAX 5000000
+#define PLL_PFD_CP2_MIN 4000000 /* lower charge pump above 4MHz */
+#define PLL_P_MAX 3
+#define PLL_N_MAX 255
+#define PLL_FRAC_BITS 20
+
+#define PLL_MATCH(_input_clk_name, _output_clk_name, _input_clk,\
+		_post_n, _n, _f1, _f2, _f3_p_cp)\
+{\
+	.input_clk_name		= _input_clk_name,\
+	.output_clk_name	= _output_clk_name,\
+	.input_clk		= _input_clk,\
+	.post_n			= _post_n,\
+	.n			= _n,\
+	.f1			= _f1,\
+	.f2			= _f2,\
+	.f3_p_cp		= _f3_p_cp,\
+}
+
+/* PLL clock setting Table */
+struct sma6201_pll_match {
+	char *input_clk_name;
+	char *output_clk_name;
+	unsigned int input_clk;
+	unsigned int post_n;
+	unsigned int n;
+	unsigned int f1;
+	unsigned int f2;
+	unsigned int f3_p_cp;
+};
+
+static struct sma6201_pll_match sma6201_pll_matches[] = {
+/* in_clk_name, out_clk_name, input_clk, post_n, n, f1, f2, f3_p_cp */
+PLL_MATCH("1.411MHz",  "24.595MHz", 1411200,  0x07, 0xF4, 0x00, 0x00, 0x03),
+PLL_MATCH("1.536MHz",  "24.576MHz", 1536000,  0x07, 0xE0, 0x00, 0x00, 0x03),
+PLL_MATCH("3.072MHz",  "24.576MHz", 3072000,  0x07, 0x70, 0x00, 0x00, 0x03),
+PLL_MATCH("6.144MHz",  "24.576MHz", 6144000,  0x07, 0x70, 0x00, 0x00, 0x07),
+PLL_MATCH("12.288MHz", "24.576MHz", 12288000, 0x07, 0x70, 0x00, 0x00, 0x0B),
+PLL_MATCH("19.2MHz",   "24.343MHz", 19200000, 0x07, 0x47, 0x00, 0x00, 0x0A),
+PLL_MATCH("24.576MHz", "24.576MHz", 24576000, 0x07, 0x70, 0x00, 0x00, 0x0F),
+};
+
+/* Solve the PLL dividers for an input clock not in the table */
+static inline int sma6201_solve_pll(unsigned int input_clk,
+		struct sma6201_pll_match *match)
+{
+	unsigned int p, pfd, n, frac;
+	u64 rem;
+
+	for (p = 0; p < PLL_P_MAX && (input_clk >> p) > PLL_PFD_MAX; p++)
+		;
+	pfd = input_clk >> p;
+	if (pfd == 0 || pfd > PLL_PFD_MAX)
+		return -EINVAL;
+
+	n = PLL_VCO_FREQ / pfd;
+	rem = PLL_VCO_FREQ % pfd;
+	frac = DIV_ROUND_CLOSEST_ULL(rem << PLL_FRAC_BITS, pfd);
+	if (frac >> PLL_FRAC_BITS) {
+		n++;
+		frac = 0;
+	}
+	if (n > PLL_N_MAX)
+		return -ERANGE;
+
+	match->input_clk_name = NULL;
+	match->output_clk_name = NULL;
+	match->input_clk = input_clk;
+	match->post_n = PLL_POST_N;
+	match->n = n;
+	match->f1 = (frac >> 12) & 0xFF;
+	match->f2 = (frac >> 4) & 0xFF;
+	match->f3_p_cp = ((frac & 0xF) << PLL_F3_SHIFT) | (p << PLL_P_SHIFT) |
+		(pfd > PLL_PFD_CP2_MIN ? PLL_CP_2 : PLL_CP_3);
+
+	return 0;
+}
+
+#endif
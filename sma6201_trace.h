@@ -0,0 +1,87 @@
+/* sma6201_trace.h -- sma6201 ALSA SoC Audio driver tracepoints
+ *
+ * Copyright 2023 Iron Device Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM sma6201
+
+#if !defined(_SMA6201_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _SMA6201_TRACE_H
+
+#include <linux/device.h>
+#include <linux/ktime.h>
+#include <linux/tracepoint.h>
+
+/* One power lifecycle phase(probe, startup, shutdown, ...) */
+TRACE_EVENT(sma6201_phase,
+
+	TP_PROTO(struct device *dev, const char *phase, s64 duration_ns),
+
+	TP_ARGS(dev, phase, duration_ns),
+
+	TP_STRUCT__entry(
+		__string(name, dev_name(dev))
+		__string(phase, phase)
+		__field(s64, duration_ns)
+	),
+
+	TP_fast_assign(
+		__assign_str(name, dev_name(dev));
+		__assign_str(phase, phase);
+		__entry->duration_ns = duration_ns;
+	),
+
+	TP_printk("%s %s duration=%lldns",
+		__get_str(name), __get_str(phase), __entry->duration_ns)
+);
+
+/* One register access of the driver, with its call site */
+TRACE_EVENT(sma6201_io,
+
+	TP_PROTO(struct device *dev, const char *site, const char *op,
+		unsigned int reg, unsigned int val, size_t count,
+		s64 duration_ns, int ret),
+
+	TP_ARGS(dev, site, op, reg, val, count, duration_ns, ret),
+
+	TP_STRUCT__entry(
+		__string(name, dev_name(dev))
+		__string(site, site)
+		__string(op, op)
+		__field(unsigned int, reg)
+		__field(unsigned int, val)
+		__field(size_t, count)
+		__field(s64, duration_ns)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		__assign_str(name, dev_name(dev));
+		__assign_str(site, site);
+		__assign_str(op, op);
+		__entry->reg = reg;
+		__entry->val = val;
+		__entry->count = count;
+		__entry->duration_ns = duration_ns;
+		__entry->ret = ret;
+	),
+
+	TP_printk("%s %s %s reg=0x%03x val=0x%02x count=%zu duration=%lldns ret=%d",
+		__get_str(name), __get_str(site), __get_str(op),
+		__entry->reg, __entry->val, __entry->count,
+		__entry->duration_ns, __entry->ret)
+);
+
+#endif /* _SMA6201_TRACE_H */
+
+/* This part must be outside protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE sma6201_trace
+#include <trace/define_trace.h>
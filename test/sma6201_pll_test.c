@@ -0,0 +1,125 @@
+/*
+ * sma6201_pll_test.c -- host check of the sma6201 PLL solver
+ *
+ * Copyright 2023 Iron Device Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Run with "make check" from the module directory.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <stdint.h>
+
+typedef uint64_t u64;
+#define DIV_ROUND_CLOSEST_ULL(x, d)	(((x) + (d) / 2) / (d))
+#define ARRAY_SIZE(a)	(sizeof(a) / sizeof((a)[0]))
+
+#include "sma6201.h"
+#include "sma6201_pll.h"
+
+#define PLL_OUT_DIV	14 /* POST_N 0x07 */
+#define PLL_OUT_FREQ	24576000
+
+static int failed;
+
+/* Output clock of a PLL setting, in Hz */
+static double pll_out_freq(const struct sma6201_pll_match *m)
+{
+	unsigned int p = (m->f3_p_cp >> PLL_P_SHIFT) & 0x3;
+	unsigned int frac = (m->f1 << 12) | (m->f2 << 4) |
+		(m->f3_p_cp >> PLL_F3_SHIFT);
+
+	return (double)(m->input_clk >> p) *
+		(m->n + (double)frac / (1 << PLL_FRAC_BITS)) / PLL_OUT_DIV;
+}
+
+static void check(int cond, const char *what, unsigned int clk)
+{
+	if (!cond) {
+		printf("FAIL %uHz : %s\n", clk, what);
+		failed++;
+	}
+}
+
+/* The table entries that are exact integer N settings must come
+ * out of the solver unchanged, the approximated ones (1.4112MHz,
+ * 19.2MHz) must be solved closer to 24.576MHz than the table
+ */
+static void test_table(void)
+{
+	struct sma6201_pll_match m;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(sma6201_pll_matches); i++) {
+		const struct sma6201_pll_match *t = &sma6201_pll_matches[i];
+		double err_t, err_s;
+
+		check(sma6201_solve_pll(t->input_clk, &m) == 0,
+			"solve", t->input_clk);
+		check(m.post_n == t->post_n, "post_n", t->input_clk);
+
+		err_t = pll_out_freq(t) - PLL_OUT_FREQ;
+		err_s = pll_out_freq(&m) - PLL_OUT_FREQ;
+		if (err_t < 0)
+			err_t = -err_t;
+		if (err_s < 0)
+			err_s = -err_s;
+
+		if (err_t == 0) {
+			check(m.n == t->n && m.f1 == t->f1 && m.f2 == t->f2 &&
+				m.f3_p_cp == t->f3_p_cp, "table entry",
+				t->input_clk);
+		} else {
+			check(err_s < err_t, "not closer than table",
+				t->input_clk);
+		}
+		check(err_s < 1.0, "output off by 1Hz or more", t->input_clk);
+
+		printf("%9uHz : N 0x%02x F1 0x%02x F2 0x%02x F3_P_CP 0x%02x"
+			" -> %.3fHz (table %.3fHz)\n", t->input_clk, m.n,
+			m.f1, m.f2, m.f3_p_cp, pll_out_freq(&m),
+			pll_out_freq(t));
+	}
+}
+
+/* Clocks outside the table and the range limits */
+static void test_range(void)
+{
+	static const unsigned int clks[] = {
+		2048000, 2822400, 5644800, 11289600, 13000000,
+		26000000,
+	};
+	struct sma6201_pll_match m;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(clks); i++) {
+		check(sma6201_solve_pll(clks[i], &m) == 0, "solve", clks[i]);
+		check(pll_out_freq(&m) > PLL_OUT_FREQ - 1.0 &&
+			pll_out_freq(&m) < PLL_OUT_FREQ + 1.0,
+			"output off by 1Hz or more", clks[i]);
+	}
+
+	/* N above 255 (1.024MHz needs 336) */
+	check(sma6201_solve_pll(1024000, &m) == -ERANGE, "-ERANGE", 1024000);
+	check(sma6201_solve_pll(0, &m) == -EINVAL, "-EINVAL", 0);
+	/* PFD above the limit even with the largest P */
+	check(sma6201_solve_pll(48000000, &m) == -EINVAL, "-EINVAL", 48000000);
+}
+
+int main(void)
+{
+	test_table();
+	test_range();
+
+	if (failed) {
+		printf("%d check(s) failed\n", failed);
+		return 1;
+	}
+	printf("all checks passed\n");
+
+	return 0;
+}